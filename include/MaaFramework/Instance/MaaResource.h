@@ -95,6 +95,14 @@ extern "C"
     MAA_FRAMEWORK_API MaaBool
         MaaResourceGetDefaultActionParam(const MaaResource* res, const char* action_type, /* out */ MaaStringBuffer* buffer);
 
+    /**
+     * @brief Get OCR session pool statistics, used to tune MaaResOption_OCRSessionPoolSize.
+     *
+     * @param buffer [out] Output buffer for the JSON string, keyed by OCR model name. Each value contains
+     * capacity, created, idle, acquired, waited, total_wait_us and max_wait_us.
+     */
+    MAA_FRAMEWORK_API MaaBool MaaResourceGetOCRSessionPoolStats(const MaaResource* res, /* out */ MaaStringBuffer* buffer);
+
 #ifdef __cplusplus
 }
 #endif
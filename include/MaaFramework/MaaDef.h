@@ -125,6 +125,13 @@ enum MaaGlobalOptionEnum
     /// value: size_t, eg: 4096; val_size: sizeof(size_t)
     /// default value is 4096
     MaaGlobalOption_RecoImageCacheLimit = 9,
+
+    /// Whether to evaluate the candidates of a node's next list concurrently
+    /// The first hit in list order is still the one taken. Nodes using Custom recognition are always run sequentially.
+    ///
+    /// value: bool, eg: true; val_size: sizeof(bool)
+    /// default value is false
+    MaaGlobalOption_ParallelNextList = 10,
 };
 
 typedef MaaOption MaaResOption;
@@ -182,6 +189,13 @@ enum MaaResOptionEnum
     /// value: MaaInferenceExecutionProvider, eg: 0; val_size: sizeof(MaaInferenceExecutionProvider)
     /// default value is MaaInferenceExecutionProvider_Auto
     MaaResOption_InferenceExecutionProvider = 2,
+
+    /// Max number of OCR model instances kept per model, shared by all taskers using this resource.
+    /// Larger values let taskers run OCR concurrently at the cost of memory.
+    ///
+    /// value: int32_t, eg: 4; val_size: sizeof(int32_t)
+    /// default value is 2
+    MaaResOption_OCRSessionPoolSize = 3,
 };
 
 typedef MaaOption MaaCtrlOption;
@@ -218,6 +232,12 @@ enum MaaCtrlOptionEnum
     //
     // value: bool, eg: true; val_size: sizeof(bool)
     // MaaCtrlOption_Recording = 5,
+
+    /// Keep capturing screenshots in background, so that capture latency overlaps with recognition.
+    /// The value is the max age of a frame that can still be used, 0 to disable.
+    ///
+    /// value: int, milliseconds, eg: 100; val_size: sizeof(int)
+    MaaCtrlOption_ContinuousScreencap = 6,
 };
 
 typedef MaaOption MaaTaskerOption;
@@ -234,11 +254,13 @@ enum MaaTaskerOptionEnum
  * Use bitwise OR to set the methods you need.
  * MaaFramework will test all provided methods and use the fastest available one.
  *
- * Default: All methods except RawByNetcat, MinicapDirect, MinicapStream
+ * Default: All methods except RawByNetcat, MinicapDirect, MinicapStream, RawStream
  *
  * Note: MinicapDirect and MinicapStream use lossy JPEG encoding, which may
  * significantly reduce template matching accuracy. Not recommended.
  *
+ * Note: MinicapStream and RawStream keep capturing on the device in the background.
+ *
  * | Method                | Speed      | Compatibility | Encoding | Notes                             |
  * |-----------------------|------------|---------------|----------|-----------------------------------|
  * | EncodeToFileAndPull   | Slow       | High          | Lossless |                                   |
@@ -248,6 +270,7 @@ enum MaaTaskerOptionEnum
  * | MinicapDirect         | Fast       | Low           | Lossy    |                                   |
  * | MinicapStream         | Very Fast  | Low           | Lossy    |                                   |
  * | EmulatorExtras        | Very Fast  | Low           | Lossless | Emulators only: MuMu 12, LDPlayer 9 |
+ * | RawStream             | Fast       | Medium        | Lossless |                                   |
  */
 typedef uint64_t MaaAdbScreencapMethod;
 #define MaaAdbScreencapMethod_EncodeToFileAndPull 1ULL
@@ -257,12 +280,13 @@ typedef uint64_t MaaAdbScreencapMethod;
 #define MaaAdbScreencapMethod_MinicapDirect (1ULL << 4)
 #define MaaAdbScreencapMethod_MinicapStream (1ULL << 5)
 #define MaaAdbScreencapMethod_EmulatorExtras (1ULL << 6)
+#define MaaAdbScreencapMethod_RawStream (1ULL << 7)
 
 #define MaaAdbScreencapMethod_None 0ULL
 #define MaaAdbScreencapMethod_All (~MaaAdbScreencapMethod_None)
 #define MaaAdbScreencapMethod_Default                                                                          \
     (MaaAdbScreencapMethod_All & (~MaaAdbScreencapMethod_RawByNetcat) & (~MaaAdbScreencapMethod_MinicapDirect) \
-     & (~MaaAdbScreencapMethod_MinicapStream))
+     & (~MaaAdbScreencapMethod_MinicapStream) & (~MaaAdbScreencapMethod_RawStream))
 
 // MaaAdbInputMethod:
 /**
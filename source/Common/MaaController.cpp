@@ -366,7 +366,8 @@ MaaBool MaaControllerCachedImage(const MaaController* ctrl, MaaImageBuffer* buff
         return false;
     }
 
-    buffer->set(std::move(img));
+    // cached_image 是与内部帧缓冲区共享的引用，交给外部前拷贝一份
+    buffer->set(img.clone());
     return true;
 }
 
@@ -455,3 +455,14 @@ MaaBool MaaResourceGetDefaultActionParam(const MaaResource* res, const char* act
     buffer->set(param_opt->dumps());
     return true;
 }
+
+MaaBool MaaResourceGetOCRSessionPoolStats(const MaaResource* res, MaaStringBuffer* buffer)
+{
+    if (!res || !buffer) {
+        LogError << "handle is null";
+        return false;
+    }
+
+    buffer->set(res->get_ocr_session_pool_stats().dumps());
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "UnitBase.h"
 
+#include "General/ShellSessionPool.h"
 #include "MaaUtils/IOStream/ChildPipeIOStream.h"
 #include "MaaUtils/Logger.h"
 
@@ -27,6 +28,14 @@ void UnitBase::merge_replacement(Replacement argv_replace, bool _override)
     }
 }
 
+void UnitBase::set_shell_pool(std::shared_ptr<ShellSessionPool> shell_pool)
+{
+    for (auto child : children_) {
+        child->set_shell_pool(shell_pool);
+    }
+    shell_pool_ = std::move(shell_pool);
+}
+
 bool UnitBase::parse_command(
     const std::string& key,
     const json::value& config,
@@ -47,6 +56,14 @@ bool UnitBase::parse_command(
 
 std::optional<std::string> UnitBase::startup_and_read_pipe(const ProcessArgv& argv, std::chrono::milliseconds timeout)
 {
+    if (shell_pool_) {
+        if (auto command_opt = shell_pool_->extract_command(argv)) {
+            if (auto result_opt = shell_pool_->run(*command_opt, timeout)) {
+                return *std::move(result_opt);
+            }
+        }
+    }
+
     auto start_time = std::chrono::steady_clock::now();
 
     ChildPipeIOStream ios(argv.exec, argv.args);
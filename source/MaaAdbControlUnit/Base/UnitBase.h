@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 
 #include <meojson/json.hpp>
 
@@ -12,6 +13,8 @@
 
 MAA_CTRL_UNIT_NS_BEGIN
 
+class ShellSessionPool;
+
 class UnitBase
 {
 public:
@@ -25,6 +28,7 @@ public:
 
     virtual void set_replacement(Replacement argv_replace);
     virtual void merge_replacement(Replacement argv_replace, bool _override = true);
+    virtual void set_shell_pool(std::shared_ptr<ShellSessionPool> shell_pool);
 
 protected:
     static bool parse_command(
@@ -39,6 +43,8 @@ protected:
 protected:
     std::vector<std::shared_ptr<UnitBase>> children_;
     Replacement argv_replace_;
+    // 非空时，adb shell 短命令优先复用常驻会话执行
+    std::shared_ptr<ShellSessionPool> shell_pool_ = nullptr;
 };
 
 class ControlUnitSink
@@ -0,0 +1,276 @@
+#include "AdbWireClient.h"
+
+#include <cstdlib>
+#include <format>
+
+#include "MaaUtils/Logger.h"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+namespace
+{
+uint16_t adb_server_port()
+{
+    constexpr uint16_t kDefaultPort = 5037;
+
+    // 与 adb 命令行一致，允许通过环境变量改端口
+    const char* env = std::getenv("ANDROID_ADB_SERVER_PORT");
+    if (!env || !*env) {
+        return kDefaultPort;
+    }
+    int port = std::atoi(env);
+    return port > 0 && port < 65536 ? static_cast<uint16_t>(port) : kDefaultPort;
+}
+
+// shell v2 协议的包类型：1 字节类型 + 4 字节小端长度 + 数据
+constexpr char kShellIdStdout = 1;
+constexpr char kShellIdStderr = 2;
+constexpr char kShellIdExit = 3;
+constexpr char kShellIdCloseStdin = 4;
+} // namespace
+
+AdbWireClient::AdbWireClient(std::string adb_serial)
+    : AdbWireClient(std::move(adb_serial), adb_server_port())
+{
+}
+
+AdbWireClient::AdbWireClient(std::string adb_serial, uint16_t server_port)
+    : adb_serial_(std::move(adb_serial))
+    , server_port_(server_port)
+{
+}
+
+std::optional<std::string> AdbWireClient::get_state()
+{
+    return host_query(std::format("host-serial:{}:get-state", adb_serial_));
+}
+
+std::optional<std::string> AdbWireClient::connect_remote()
+{
+    return host_query(std::format("host:connect:{}", adb_serial_));
+}
+
+std::optional<std::string> AdbWireClient::get_features()
+{
+    return host_query(std::format("host-serial:{}:features", adb_serial_));
+}
+
+std::optional<std::optional<std::string>> AdbWireClient::shell(const std::string& cmd, std::chrono::milliseconds timeout)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    auto result = shell_v2_supported_ ? shell_v2(cmd, timeout) : exec(cmd, timeout);
+    if (!result) {
+        return std::nullopt;
+    }
+
+    auto duration = duration_since(start_time);
+    LogDebug << VAR(cmd) << VAR(duration) << VAR(result->has_value());
+    return result;
+}
+
+std::shared_ptr<SockIOStream> AdbWireClient::connect_server()
+{
+    ClientSockIOFactory io_factory("127.0.0.1", server_port_);
+    return io_factory.connect();
+}
+
+std::shared_ptr<SockIOStream> AdbWireClient::open_transport()
+{
+    auto ios = connect_server();
+    if (!ios) {
+        return nullptr;
+    }
+
+    if (!send_request(*ios, std::format("host:transport:{}", adb_serial_))) {
+        return nullptr;
+    }
+    return ios;
+}
+
+bool AdbWireClient::send_request(SockIOStream& ios, const std::string& payload)
+{
+    if (!ios.write(std::format("{:04x}{}", payload.size(), payload))) {
+        LogWarn << "failed to write adb server" << VAR(payload);
+        return false;
+    }
+
+    using namespace std::chrono_literals;
+    auto status = read_exact(ios, 4, std::chrono::steady_clock::now() + 5s);
+    if (!status) {
+        LogWarn << "failed to read adb server status" << VAR(payload);
+        return false;
+    }
+    if (*status == "OKAY") {
+        return true;
+    }
+
+    auto message = *status == "FAIL" ? read_length_prefixed(ios) : std::nullopt;
+    LogDebug << "adb server refused" << VAR(payload) << VAR(*status) << VAR(message);
+    return false;
+}
+
+std::optional<std::string> AdbWireClient::read_length_prefixed(SockIOStream& ios)
+{
+    using namespace std::chrono_literals;
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+
+    auto length_hex = read_exact(ios, 4, deadline);
+    if (!length_hex) {
+        return std::nullopt;
+    }
+
+    size_t length = 0;
+    try {
+        length = std::stoul(*length_hex, nullptr, 16);
+    }
+    catch (const std::exception& e) {
+        LogError << "invalid length" << VAR(*length_hex) << VAR(e.what());
+        return std::nullopt;
+    }
+    return read_exact(ios, length, deadline);
+}
+
+std::optional<std::string> AdbWireClient::read_exact(SockIOStream& ios, size_t count, std::chrono::steady_clock::time_point deadline)
+{
+    std::string result;
+    result.reserve(count);
+
+    while (result.size() < count) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return std::nullopt;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+
+        std::optional<std::string> chunk = ios.read_some(count - result.size(), remaining);
+        if (!chunk || chunk->empty()) {
+            return std::nullopt;
+        }
+        result.append(*chunk);
+    }
+    return result;
+}
+
+std::optional<std::string> AdbWireClient::host_query(const std::string& payload)
+{
+    auto ios = connect_server();
+    if (!ios) {
+        return std::nullopt;
+    }
+    if (!send_request(*ios, payload)) {
+        return std::nullopt;
+    }
+    return read_length_prefixed(*ios);
+}
+
+std::optional<std::optional<std::string>> AdbWireClient::shell_v2(const std::string& cmd, std::chrono::milliseconds timeout)
+{
+    auto ios = open_transport();
+    if (!ios) {
+        return std::nullopt;
+    }
+
+    if (!send_request(*ios, std::format("shell,v2,raw:{}", cmd))) {
+        // 被拒绝时命令还没有被执行。可能只是设备暂时断开，
+        // 确认设备确实不支持 shell v2 才永久换成 exec:
+        auto features = get_features();
+        if (!features || features->find("shell_v2") != std::string::npos) {
+            LogWarn << "shell v2 request failed" << VAR(cmd) << VAR(features);
+            return std::nullopt;
+        }
+
+        LogInfo << "shell v2 unsupported, fallback to exec" << VAR(features);
+        shell_v2_supported_ = false;
+        return exec(cmd, timeout);
+    }
+
+    // 没有输入，直接关掉 stdin，避免命令等待
+    ios->write(std::string { kShellIdCloseStdin, 0, 0, 0, 0 });
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::string output;
+
+    while (true) {
+        auto header = read_exact(*ios, 5, deadline);
+        if (!header) {
+            LogError << "shell v2 read failed or timeout" << VAR(cmd) << VAR(timeout) << VAR(output.size());
+            return std::optional<std::string>(std::nullopt);
+        }
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(header->data());
+        const size_t length = bytes[1] | (bytes[2] << 8) | (bytes[3] << 16) | (static_cast<size_t>(bytes[4]) << 24);
+
+        auto data = read_exact(*ios, length, deadline);
+        if (!data) {
+            LogError << "shell v2 read failed or timeout" << VAR(cmd) << VAR(timeout) << VAR(output.size());
+            return std::optional<std::string>(std::nullopt);
+        }
+
+        switch (header->front()) {
+        case kShellIdStdout:
+            output.append(*data);
+            break;
+
+        case kShellIdStderr:
+            LogDebug << "stderr:" << *data;
+            break;
+
+        case kShellIdExit: {
+            int code = data->empty() ? -1 : static_cast<unsigned char>(data->front());
+            if (code != 0) {
+                LogError << "command return error" << VAR(cmd) << VAR(code);
+                return std::optional<std::string>(std::nullopt);
+            }
+            return std::optional<std::string>(std::move(output));
+        }
+
+        default:
+            break;
+        }
+    }
+}
+
+std::optional<std::optional<std::string>> AdbWireClient::exec(const std::string& cmd, std::chrono::milliseconds timeout)
+{
+    auto ios = open_transport();
+    if (!ios) {
+        return std::nullopt;
+    }
+
+    if (!send_request(*ios, std::format("exec:{}", cmd))) {
+        return std::nullopt;
+    }
+
+    // exec: 是原始字节流，没有退出码，读到对端关闭为止
+    // 到了超时对端还没关，说明输出不完整（如截了一半的 raw 图），按失败处理
+    constexpr size_t kChunkSize = 64 * 1024;
+
+    ios->expires_after(timeout);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::string output;
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            LogError << "exec timeout" << VAR(cmd) << VAR(timeout) << VAR(output.size());
+            return std::optional<std::string>(std::nullopt);
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+
+        std::string chunk = ios->read_some(kChunkSize, remaining);
+        if (chunk.empty()) {
+            // read_some 超时和对端关闭都返回空，按是否到了 deadline 区分
+            if (std::chrono::steady_clock::now() >= deadline) {
+                LogError << "exec timeout" << VAR(cmd) << VAR(timeout) << VAR(output.size());
+                return std::optional<std::string>(std::nullopt);
+            }
+            break;
+        }
+        output.append(chunk);
+    }
+
+    return std::optional<std::string>(std::move(output));
+}
+
+MAA_CTRL_UNIT_NS_END
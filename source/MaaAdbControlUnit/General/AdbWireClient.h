@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "MaaUtils/IOStream/SockIOStream.h"
+
+#include "Common/Conf.h"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+// 直接和本机 adb server（默认 127.0.0.1:5037）说话，不再为每条命令拉起 adb 进程
+// adb server 没起来时所有请求都返回 nullopt，调用方回退到原来的命令行方式
+class AdbWireClient
+{
+public:
+    explicit AdbWireClient(std::string adb_serial);
+    // 指定 adb server 端口，测试时连到假的 server 上
+    AdbWireClient(std::string adb_serial, uint16_t server_port);
+
+public:
+    // host-serial:<serial>:get-state，返回 "device" / "offline" 等
+    std::optional<std::string> get_state();
+    // host:connect:<serial>，返回 adb server 的提示信息
+    std::optional<std::string> connect_remote();
+    // host-serial:<serial>:features，逗号分隔的特性列表，如 "shell_v2,cmd,..."
+    std::optional<std::string> get_features();
+
+    // 外层为 nullopt 表示没能把命令交给设备（server 不可达、设备不存在等），可以安全回退；
+    // 内层为 nullopt 表示命令执行了但失败或超时，与 startup_and_read_pipe 的返回值一致
+    std::optional<std::optional<std::string>> shell(const std::string& cmd, std::chrono::milliseconds timeout);
+
+private:
+    std::shared_ptr<SockIOStream> connect_server();
+    std::shared_ptr<SockIOStream> open_transport();
+
+    bool send_request(SockIOStream& ios, const std::string& payload);
+    std::optional<std::string> read_length_prefixed(SockIOStream& ios);
+    std::optional<std::string> read_exact(SockIOStream& ios, size_t count, std::chrono::steady_clock::time_point deadline);
+    std::optional<std::string> host_query(const std::string& payload);
+
+    std::optional<std::optional<std::string>> shell_v2(const std::string& cmd, std::chrono::milliseconds timeout);
+    std::optional<std::optional<std::string>> exec(const std::string& cmd, std::chrono::milliseconds timeout);
+
+    const std::string adb_serial_;
+    const uint16_t server_port_;
+
+    // 设备是否支持 shell v2（能拿到退出码），被拒绝且 features 里确实没有时才改用 exec:
+    std::atomic_bool shell_v2_supported_ = true;
+};
+
+MAA_CTRL_UNIT_NS_END
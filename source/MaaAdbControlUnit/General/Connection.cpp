@@ -7,6 +7,7 @@ MAA_CTRL_UNIT_NS_BEGIN
 Connection::Connection(std::filesystem::path adb_path, std::string adb_serial)
     : adb_path_(std::move(adb_path))
     , adb_serial_(std::move(adb_serial))
+    , wire_client_(adb_serial_)
 {
 }
 
@@ -82,14 +83,18 @@ bool Connection::test_connection()
 {
     LogFunc;
 
-    auto argv_opt = test_connection_argv_.gen(argv_replace_);
-    if (!argv_opt) {
-        return false;
-    }
-
-    auto output_opt = startup_and_read_pipe(*argv_opt);
+    // adb server 已经在跑时直接问它，否则走命令行，顺带把 server 拉起来
+    auto output_opt = wire_client_.get_state();
     if (!output_opt) {
-        return false;
+        auto argv_opt = test_connection_argv_.gen(argv_replace_);
+        if (!argv_opt) {
+            return false;
+        }
+
+        output_opt = startup_and_read_pipe(*argv_opt);
+        if (!output_opt) {
+            return false;
+        }
     }
 
     // get-state 返回 "device" 表示设备正常连接，"offline" 或 "bootloader" 表示不可用
@@ -98,15 +103,18 @@ bool Connection::test_connection()
 
 bool Connection::connect_remote()
 {
-    auto argv_opt = connect_argv_.gen(argv_replace_);
-    if (!argv_opt) {
-        return false;
-    }
-
-    using namespace std::chrono_literals;
-    auto output_opt = startup_and_read_pipe(*argv_opt, 60s);
+    auto output_opt = wire_client_.connect_remote();
     if (!output_opt) {
-        return false;
+        auto argv_opt = connect_argv_.gen(argv_replace_);
+        if (!argv_opt) {
+            return false;
+        }
+
+        using namespace std::chrono_literals;
+        output_opt = startup_and_read_pipe(*argv_opt, 60s);
+        if (!output_opt) {
+            return false;
+        }
     }
 
     constexpr std::array<std::string_view, 4> kErrorFlag = { "error", "cannot", "refused", "unable to connect" };
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "Base/UnitBase.h"
+#include "General/AdbWireClient.h"
 #include "MaaUtils/IOStream/ChildPipeIOStream.h"
 
 #include "Common/Conf.h"
@@ -35,6 +36,8 @@ private:
     std::filesystem::path adb_path_;
     std::string adb_serial_;
 
+    AdbWireClient wire_client_;
+
     ProcessArgvGenerator connect_argv_;
     ProcessArgvGenerator kill_server_argv_;
     ProcessArgvGenerator test_connection_argv_;
@@ -0,0 +1,248 @@
+#include "ShellSessionPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+
+#include "MaaUtils/Logger.h"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+ShellSessionPool::ShellSessionPool(std::string adb_serial)
+    : wire_client_(std::move(adb_serial))
+{
+}
+
+ShellSessionPool::~ShellSessionPool()
+{
+    auto avg_us = [](const PathStats& stats) {
+        return stats.count ? stats.total.count() / static_cast<int64_t>(stats.count) : 0;
+    };
+    LogInfo << "shell pool stats" << VAR(session_stats_.count) << VAR(avg_us(session_stats_)) << VAR(wire_stats_.count)
+            << VAR(avg_us(wire_stats_));
+
+    release_all();
+}
+
+bool ShellSessionPool::parse(const json::value& config)
+{
+    static const json::array kDefaultShellSessionArgv = {
+        "{ADB}",
+        "-s",
+        "{ADB_SERIAL}",
+        "shell",
+    };
+
+    return parse_command("ShellSession", config, kDefaultShellSessionArgv, session_argv_);
+}
+
+std::optional<std::string> ShellSessionPool::extract_command(const ProcessArgv& argv) const
+{
+    auto session_argv_opt = session_argv_.gen(argv_replace_);
+    if (!session_argv_opt) {
+        return std::nullopt;
+    }
+    const auto& session_args = session_argv_opt->args;
+
+    if (argv.exec != session_argv_opt->exec || session_args.empty() || session_args.back() != "shell"
+        || argv.args.size() != session_args.size() + 1) {
+        return std::nullopt;
+    }
+
+    const size_t n = session_args.size() - 1;
+    if (!std::equal(session_args.begin(), session_args.begin() + n, argv.args.begin())) {
+        return std::nullopt;
+    }
+    if (argv.args[n] != "shell" && argv.args[n] != "exec-out") {
+        return std::nullopt;
+    }
+
+    return argv.args.back();
+}
+
+std::optional<std::optional<std::string>> ShellSessionPool::run(const std::string& command, std::chrono::milliseconds timeout)
+{
+    // 按开销从小到大：
+    // 1. 空闲的常驻会话，只是往已有管道里写一行，不用建连接也不用起进程
+    // 2. adb server 直连，每条命令一个新 TCP 连接
+    // 3. 会话都在忙且 server 不可直连时，等一个会话空出来
+    // 都不行才返回 nullopt，由调用方启动新进程
+    auto start_time = std::chrono::steady_clock::now();
+
+    if (auto session = acquire(false)) {
+        if (auto result = run_in_session(session, command, timeout)) {
+            record(session_stats_, start_time);
+            return result;
+        }
+    }
+
+    if (auto result = wire_client_.shell(command, timeout)) {
+        record(wire_stats_, start_time);
+        return result;
+    }
+
+    if (auto session = acquire(true)) {
+        if (auto result = run_in_session(session, command, timeout)) {
+            record(session_stats_, start_time);
+            return result;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::optional<std::string>>
+    ShellSessionPool::run_in_session(std::shared_ptr<Session> session, const std::string& command, std::chrono::milliseconds timeout)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    // 命令放进 { } 里，stdin 接 /dev/null，避免命令把后面写进来的内容读走
+    const std::string marker = std::format("MAA_SHELL_END_{}_{}:", session->id, ++session->seq);
+    const std::string script = std::format("{{ {}\n}} </dev/null\nprintf '%s%d\\n' {} $?\n", command, marker);
+
+    if (!session->ios->write(script)) {
+        LogWarn << "failed to write shell session, fallback" << VAR(session->id);
+        drop(session);
+        return std::nullopt;
+    }
+
+    std::string output = session->ios->read_until(marker, timeout);
+    if (!output.ends_with(marker)) {
+        // 命令可能还在跑，这个会话已经对不齐了，不能再复用，也不能回退重新执行
+        LogError << "shell session timeout" << VAR(command) << VAR(timeout) << VAR(output.size());
+        drop(session);
+        return std::optional<std::string>(std::nullopt);
+    }
+    output.resize(output.size() - marker.size());
+
+    using namespace std::chrono_literals;
+    std::string code_str = session->ios->read_until("\n", 1s);
+    give_back(session);
+
+    auto duration = duration_since(start_time);
+    LogDebug << VAR(output.size()) << VAR(duration) << VAR(code_str);
+    if (!output.empty() && output.size() < 4096) {
+        LogDebug << MAA_LOG_NS::separator::newline << "output:" << output;
+    }
+
+    if (!code_str.ends_with("\n") || std::atoi(code_str.c_str()) != 0) {
+        LogError << "command return error" << VAR(command) << VAR(code_str);
+        return std::optional<std::string>(std::nullopt);
+    }
+
+    return std::optional<std::string>(std::move(output));
+}
+
+void ShellSessionPool::record(PathStats& stats, std::chrono::steady_clock::time_point start_time)
+{
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+
+    std::unique_lock lock(mutex_);
+    ++stats.count;
+    stats.total += cost;
+}
+
+void ShellSessionPool::release_all()
+{
+    std::unique_lock lock(mutex_);
+
+    for (const auto& session : idle_) {
+        session->ios->write("exit\n");
+        session->ios->release();
+    }
+    created_ -= idle_.size();
+    idle_.clear();
+}
+
+std::shared_ptr<ShellSessionPool::Session> ShellSessionPool::acquire(bool wait)
+{
+    std::unique_lock lock(mutex_);
+
+    while (!disabled_) {
+        if (!idle_.empty()) {
+            auto session = std::move(idle_.back());
+            idle_.pop_back();
+            return session;
+        }
+
+        if (created_ < kMaxSessions) {
+            // 先占坑再解锁启动，避免别的线程同时超额创建
+            ++created_;
+            lock.unlock();
+            auto session = start_session();
+            lock.lock();
+
+            if (session) {
+                return session;
+            }
+
+            --created_;
+            disabled_ = true;
+            cond_.notify_all();
+            break;
+        }
+
+        if (!wait) {
+            break;
+        }
+        cond_.wait(lock);
+    }
+
+    return nullptr;
+}
+
+void ShellSessionPool::give_back(std::shared_ptr<Session> session)
+{
+    {
+        std::unique_lock lock(mutex_);
+        if (session->ios->running()) {
+            idle_.emplace_back(std::move(session));
+        }
+        else {
+            --created_;
+        }
+    }
+    cond_.notify_one();
+}
+
+void ShellSessionPool::drop(std::shared_ptr<Session> session)
+{
+    session->ios->release();
+    {
+        std::unique_lock lock(mutex_);
+        --created_;
+    }
+    cond_.notify_one();
+}
+
+std::shared_ptr<ShellSessionPool::Session> ShellSessionPool::start_session()
+{
+    LogFunc;
+
+    auto argv_opt = session_argv_.gen(argv_replace_);
+    if (!argv_opt) {
+        return nullptr;
+    }
+
+    auto ios = std::make_shared<ChildPipeIOStream>(argv_opt->exec, argv_opt->args);
+
+    // 分配了 pty 的 shell 会回显命令、把 \n 换成 \r\n，二进制输出会被破坏，这种设备不用会话
+    constexpr std::string_view kReady = "MAA_SHELL_READY\n";
+    using namespace std::chrono_literals;
+    if (!ios->write("printf '%s\\n' MAA_SHELL_READY\n") || ios->read_until(kReady, 5s) != kReady) {
+        LogWarn << "shell session unavailable, fallback to one process per command" << VAR(argv_opt->exec) << VAR(argv_opt->args);
+        ios->release();
+        return nullptr;
+    }
+
+    static std::atomic_uint64_t s_session_id = 0;
+    auto session = std::make_shared<Session>();
+    session->id = ++s_session_id;
+    session->ios = std::move(ios);
+
+    LogInfo << "shell session started" << VAR(session->id);
+    return session;
+}
+
+MAA_CTRL_UNIT_NS_END
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Base/UnitBase.h"
+#include "General/AdbWireClient.h"
+#include "MaaUtils/IOStream/ChildPipeIOStream.h"
+
+#include "Common/Conf.h"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+// 常驻的 adb shell 会话池。短命令写进已有的 shell 里执行，用标记分隔输出，省掉每次拉起 adb 进程的开销
+// 会话都在忙时改走 adb server 协议直连，两条路各自的次数和平均耗时在析构时打出来
+class ShellSessionPool : public UnitBase
+{
+public:
+    explicit ShellSessionPool(std::string adb_serial);
+    virtual ~ShellSessionPool() override;
+
+public: // from UnitBase
+    virtual bool parse(const json::value& config) override;
+
+public:
+    // argv 是 "<session argv> <command>" 或 "<session argv 去掉 shell> exec-out <command>" 的形式时，取出 command
+    std::optional<std::string> extract_command(const ProcessArgv& argv) const;
+
+    // 内层返回值同 startup_and_read_pipe；外层为 nullopt 表示命令没有执行（会话不可用），由调用方回退到启动新进程
+    std::optional<std::optional<std::string>> run(const std::string& command, std::chrono::milliseconds timeout);
+
+    void release_all();
+
+private:
+    struct Session
+    {
+        uint64_t id = 0;
+        uint64_t seq = 0;
+        std::shared_ptr<ChildPipeIOStream> ios = nullptr;
+    };
+
+    struct PathStats
+    {
+        size_t count = 0;
+        std::chrono::microseconds total { };
+    };
+
+    std::optional<std::optional<std::string>>
+        run_in_session(std::shared_ptr<Session> session, const std::string& command, std::chrono::milliseconds timeout);
+    void record(PathStats& stats, std::chrono::steady_clock::time_point start_time);
+
+    // wait 为 false 时会话都在忙就直接返回 nullptr
+    std::shared_ptr<Session> acquire(bool wait);
+    void give_back(std::shared_ptr<Session> session);
+    void drop(std::shared_ptr<Session> session);
+    std::shared_ptr<Session> start_session();
+
+    // 输入和截图各占一个就够了
+    static constexpr size_t kMaxSessions = 2;
+
+    AdbWireClient wire_client_;
+    ProcessArgvGenerator session_argv_;
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<std::shared_ptr<Session>> idle_;
+    size_t created_ = 0;
+    // 设备不支持（例如 shell 分配了 pty），之后都走启动新进程
+    bool disabled_ = false;
+
+    PathStats session_stats_;
+    PathStats wire_stats_;
+};
+
+MAA_CTRL_UNIT_NS_END
@@ -49,10 +49,25 @@ bool AdbControlUnitMgr::connect()
 
     clear_observer();
 
+    // 重连后旧会话都已失效，整个池子重建
+    shell_pool_ = std::make_shared<ShellSessionPool>(adb_serial_);
+    if (shell_pool_->parse(config_)) {
+        shell_pool_->set_replacement(unit_replacement_);
+    }
+    else {
+        LogWarn << "failed to parse shell session, fallback to one process per command";
+        shell_pool_ = nullptr;
+    }
+
+    device_info_.set_shell_pool(shell_pool_);
+    activity_.set_shell_pool(shell_pool_);
+    adb_command_.set_shell_pool(shell_pool_);
+
     if (screencap_methods_ != MaaAdbScreencapMethod_None) {
         screencap_ = std::make_shared<ScreencapAgent>(screencap_methods_, agent_path_);
         screencap_->parse(config_);
         screencap_->set_replacement(unit_replacement_);
+        screencap_->set_shell_pool(shell_pool_);
 
         if (!screencap_->init()) {
             LogError << "failed to init screencap";
@@ -69,6 +84,7 @@ bool AdbControlUnitMgr::connect()
         input_ = std::make_shared<InputAgent>(input_methods_, agent_path_);
         input_->parse(config_);
         input_->set_replacement(unit_replacement_);
+        input_->set_shell_pool(shell_pool_);
 
         if (!input_->init()) {
             LogError << "failed to init input";
@@ -372,6 +388,9 @@ json::object AdbControlUnitMgr::get_info() const
     info["input_methods"] = static_cast<int64_t>(input_methods_);
     info["agent_path"] = path_to_utf8_string(agent_path_);
     info["config"] = config_;
+    if (screencap_) {
+        info["screencap"] = screencap_->get_info();
+    }
     return info;
 }
 
@@ -9,6 +9,8 @@
 #include "General/Connection.h"
 #include "General/DeviceInfo.h"
 #include "General/DeviceList.h"
+#include "General/ShellSessionPool.h"
+#include "Manager/ScreencapAgent.h"
 #include "MaaUtils/Dispatcher.hpp"
 
 #include "Common/Conf.h"
@@ -84,9 +86,10 @@ private:
     DeviceInfo device_info_;
     Activity activity_;
     AdbCommand adb_command_;
+    std::shared_ptr<ShellSessionPool> shell_pool_ = nullptr;
 
     std::shared_ptr<InputBase> input_ = nullptr;
-    std::shared_ptr<ScreencapBase> screencap_ = nullptr;
+    std::shared_ptr<ScreencapAgent> screencap_ = nullptr;
 
     bool screencap_available_ = false;
     std::pair<int, int> image_resolution_;
@@ -1,5 +1,6 @@
 #include "ScreencapAgent.h"
 
+#include <algorithm>
 #include <format>
 #include <ranges>
 #include <unordered_set>
@@ -14,6 +15,7 @@
 #include "Screencap/Minicap/MinicapDirect.h"
 #include "Screencap/Minicap/MinicapStream.h"
 #include "Screencap/RawByNetcat.h"
+#include "Screencap/RawStream.h"
 #include "Screencap/RawWithGzip.h"
 
 MAA_CTRL_UNIT_NS_BEGIN
@@ -33,6 +35,9 @@ ScreencapAgent::ScreencapAgent(MaaAdbScreencapMethod methods, const std::filesys
     if (methods & MaaAdbScreencapMethod_RawByNetcat) {
         method_set.emplace(ScreencapAgent::Method::RawByNetcat);
     }
+    if (methods & MaaAdbScreencapMethod_RawStream) {
+        method_set.emplace(ScreencapAgent::Method::RawStream);
+    }
     if (methods & MaaAdbScreencapMethod_MinicapDirect) {
         method_set.emplace(ScreencapAgent::Method::MinicapDirect);
     }
@@ -62,6 +67,9 @@ ScreencapAgent::ScreencapAgent(MaaAdbScreencapMethod methods, const std::filesys
         case Method::RawWithGzip:
             unit = std::make_shared<ScreencapRawWithGzip>();
             break;
+        case Method::RawStream:
+            unit = std::make_shared<ScreencapRawStream>();
+            break;
         case Method::Encode:
             unit = std::make_shared<ScreencapEncode>();
             break;
@@ -150,13 +158,25 @@ bool ScreencapAgent::init()
         }
     }
 
-    active_unit_ = speed_test();
-    if (!active_unit_) {
+    Method fastest = speed_test();
+    if (fastest == Method::UnknownYet) {
         LogError << "No available screencap method";
         return false;
     }
 
-    units_.clear();
+    // 流式的方式闲着也要占着设备和线程，没选中就释放
+    // 其余可用的方式留着，之后按运行中的统计随时切换
+    std::vector<Method> idle_streams;
+    for (const auto& [method, unit] : units_) {
+        if (method != fastest && is_streaming(method)) {
+            idle_streams.emplace_back(method);
+        }
+    }
+    for (Method method : idle_streams) {
+        release_unit(method);
+    }
+
+    switch_to(fastest, "speed test");
     return true;
 }
 
@@ -167,48 +187,135 @@ std::optional<cv::Mat> ScreencapAgent::screencap()
         return std::nullopt;
     }
 
-    return active_unit_->screencap();
+    constexpr uint64_t kProbeInterval = 30;
+
+    // 隔一段时间换个方式截一次，让其他方式的统计保持新鲜；截到的图照常返回，不额外多截
+    if (units_.size() > 1 && ++screencap_count_ % kProbeInterval == 0) {
+        if (auto candidate = next_probe_method()) {
+            if (auto img_opt = screencap_by(*candidate)) {
+                maybe_switch();
+                return img_opt;
+            }
+        }
+    }
+
+    if (auto img_opt = screencap_by(active_method_)) {
+        maybe_switch();
+        return img_opt;
+    }
+
+    // 当前方式失败了，按统计从好到差试其他方式，能用就直接切过去
+    Method failed = active_method_;
+    for (Method method : ranked_methods()) {
+        if (method == failed) {
+            continue;
+        }
+        if (auto img_opt = screencap_by(method)) {
+            switch_to(method, "active method failed");
+            return img_opt;
+        }
+    }
+
+    return std::nullopt;
 }
 
 void ScreencapAgent::on_image_resolution_changed(const std::pair<int, int>& pre, const std::pair<int, int>& cur)
 {
-    if (!active_unit_) {
-        LogError << "active_unit_ is null";
-        return;
+    // 备用的方式随时可能被切过去，也要同步
+    for (auto& [method, unit] : units_) {
+        unit->on_image_resolution_changed(pre, cur);
     }
-
-    active_unit_->on_image_resolution_changed(pre, cur);
 }
 
 void ScreencapAgent::on_app_started(const std::string& intent)
 {
-    if (!active_unit_) {
-        LogError << "active_unit_ is null";
-        return;
+    for (auto& [method, unit] : units_) {
+        unit->on_app_started(intent);
     }
-
-    active_unit_->on_app_started(intent);
 }
 
 void ScreencapAgent::on_app_stopped(const std::string& intent)
 {
-    if (!active_unit_) {
-        LogError << "active_unit_ is null";
-        return;
+    for (auto& [method, unit] : units_) {
+        unit->on_app_stopped(intent);
+    }
+}
+
+json::object ScreencapAgent::get_info() const
+{
+    std::unique_lock lock(stats_mutex_);
+
+    json::object methods;
+    for (const auto& [method, stats] : stats_) {
+        methods[method_name(method)] = stats.to_json();
+    }
+
+    return {
+        { "active", method_name(active_method_) },
+        { "methods", std::move(methods) },
+    };
+}
+
+void ScreencapAgent::MethodStats::record(std::optional<std::chrono::milliseconds> cost)
+{
+    ++total;
+    if (!cost) {
+        ++failed;
     }
 
-    active_unit_->on_app_stopped(intent);
+    window.emplace_back(cost);
+    if (window.size() > kWindowSize) {
+        window.pop_front();
+    }
 }
 
-std::shared_ptr<ScreencapBase> ScreencapAgent::speed_test()
+std::optional<std::chrono::milliseconds> ScreencapAgent::MethodStats::median() const
+{
+    std::vector<std::chrono::milliseconds> costs;
+    for (const auto& cost : window) {
+        if (cost) {
+            costs.emplace_back(*cost);
+        }
+    }
+    if (costs.empty()) {
+        return std::nullopt;
+    }
+
+    auto mid = costs.begin() + costs.size() / 2;
+    std::nth_element(costs.begin(), mid, costs.end());
+    return *mid;
+}
+
+size_t ScreencapAgent::MethodStats::recent_failures() const
+{
+    return std::ranges::count_if(window, [](const auto& cost) { return !cost; });
+}
+
+json::object ScreencapAgent::MethodStats::to_json() const
+{
+    json::array recent;
+    for (const auto& cost : window) {
+        recent.emplace_back(cost ? json::value(cost->count()) : json::value(nullptr));
+    }
+
+    auto median_opt = median();
+    return {
+        { "total", total },
+        { "failed", failed },
+        { "recent_failures", recent_failures() },
+        { "median_ms", median_opt ? json::value(median_opt->count()) : json::value(nullptr) },
+        { "recent_ms", std::move(recent) },
+    };
+}
+
+ScreencapAgent::Method ScreencapAgent::speed_test()
 {
     LogFunc;
 
     Method fastest = Method::UnknownYet;
     std::chrono::milliseconds cost(INT64_MAX);
 
-    auto check = [&fastest, &cost](Method method, std::chrono::steady_clock::time_point start) {
-        auto duration = duration_since(start);
+    auto check = [&fastest, &cost](Method method, std::chrono::milliseconds duration) {
         if (duration < cost) {
             fastest = method;
             cost = duration;
@@ -225,26 +332,223 @@ std::shared_ptr<ScreencapBase> ScreencapAgent::speed_test()
             LogInfo << "Testing" << method << "drop first";
             if (!unit->screencap()) {
                 LogWarn << "failed to test" << method;
+                std::unique_lock lock(stats_mutex_);
+                stats_[method].record(std::nullopt);
                 continue;
             }
         }
 
         LogInfo << "Testing" << method;
         auto now = std::chrono::steady_clock::now();
-        if (!unit->screencap()) {
+        bool ret = unit->screencap().has_value();
+        auto duration = duration_since(now);
+
+        {
+            std::unique_lock lock(stats_mutex_);
+            stats_[method].record(ret ? std::make_optional(duration) : std::nullopt);
+        }
+
+        if (!ret) {
             LogWarn << "failed to test" << method;
             continue;
         }
-        check(method, now);
+        check(method, duration);
     }
 
     if (fastest == Method::UnknownYet) {
         LogError << "cannot find any method to screencap!";
-        return nullptr;
+        return Method::UnknownYet;
     }
 
     LogInfo << "The fastest method is" << fastest << VAR(cost);
-    return units_[fastest];
+    return fastest;
+}
+
+std::optional<cv::Mat> ScreencapAgent::screencap_by(Method method)
+{
+    auto it = units_.find(method);
+    if (it == units_.end()) {
+        return std::nullopt;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto img_opt = it->second->screencap();
+    auto duration = duration_since(now);
+
+    std::unique_lock lock(stats_mutex_);
+    stats_[method].record(img_opt ? std::make_optional(duration) : std::nullopt);
+    return img_opt;
+}
+
+std::optional<ScreencapAgent::Method> ScreencapAgent::next_probe_method()
+{
+    // 探测的这一帧是要直接返回给调用方的，明显比当前方式慢的（如 1s 左右的 EncodeToFileAndPull）不拿来探测
+    // 没有成功记录的也不探测，它们只在当前方式失败时作为后备
+    constexpr int kMaxSlowdown = 2;
+
+    std::vector<Method> others;
+    {
+        std::unique_lock lock(stats_mutex_);
+
+        auto active_it = stats_.find(active_method_);
+        auto active_cost = active_it == stats_.end() ? std::nullopt : active_it->second.median();
+        if (!active_cost) {
+            return std::nullopt;
+        }
+
+        for (const auto& [method, unit] : units_) {
+            if (method == active_method_) {
+                continue;
+            }
+            auto it = stats_.find(method);
+            auto cost = it == stats_.end() ? std::nullopt : it->second.median();
+            if (cost && *cost <= *active_cost * kMaxSlowdown) {
+                others.emplace_back(method);
+            }
+        }
+    }
+    if (others.empty()) {
+        return std::nullopt;
+    }
+    std::ranges::sort(others);
+    return others[probe_cursor_++ % others.size()];
+}
+
+std::vector<ScreencapAgent::Method> ScreencapAgent::ranked_methods() const
+{
+    std::unique_lock lock(stats_mutex_);
+
+    // 近期失败少的优先，其次看耗时中位数，没有成功记录的排最后
+    auto key = [&](Method method) {
+        auto it = stats_.find(method);
+        if (it == stats_.end()) {
+            return std::make_pair(size_t(0), std::chrono::milliseconds::max());
+        }
+        return std::make_pair(it->second.recent_failures(), it->second.median().value_or(std::chrono::milliseconds::max()));
+    };
+
+    std::vector<Method> methods;
+    for (const auto& [method, unit] : units_) {
+        methods.emplace_back(method);
+    }
+    std::ranges::sort(methods, [&](Method lhs, Method rhs) { return key(lhs) < key(rhs); });
+    return methods;
+}
+
+void ScreencapAgent::maybe_switch()
+{
+    constexpr size_t kMinSamples = 3;
+    constexpr size_t kMaxRecentFailures = 2;
+
+    Method best = Method::UnknownYet;
+    std::chrono::milliseconds best_cost = std::chrono::milliseconds::max();
+    std::optional<std::chrono::milliseconds> active_cost;
+    bool active_unhealthy = false;
+
+    {
+        std::unique_lock lock(stats_mutex_);
+
+        for (const auto& [method, stats] : stats_) {
+            if (!units_.contains(method)) {
+                continue;
+            }
+            if (method == active_method_) {
+                active_cost = stats.median();
+                active_unhealthy = stats.recent_failures() > kMaxRecentFailures;
+                continue;
+            }
+            if (stats.window.size() < kMinSamples || stats.recent_failures() > 0) {
+                continue;
+            }
+            auto cost = stats.median();
+            if (cost && *cost < best_cost) {
+                best = method;
+                best_cost = *cost;
+            }
+        }
+    }
+
+    if (best == Method::UnknownYet) {
+        return;
+    }
+
+    if (active_unhealthy) {
+        switch_to(best, "active method keeps failing");
+    }
+    // 留点余量，避免两个差不多快的方式来回切
+    else if (active_cost && best_cost * 10 < *active_cost * 8) {
+        switch_to(best, "active method degraded");
+    }
+}
+
+void ScreencapAgent::switch_to(Method method, std::string_view reason)
+{
+    auto it = units_.find(method);
+    if (it == units_.end()) {
+        LogError << "method not available" << method;
+        return;
+    }
+
+    if (method != active_method_) {
+        LogInfo << "switch screencap method" << VAR(active_method_) << "->" << method << VAR(reason);
+    }
+
+    Method previous = active_method_;
+    {
+        std::unique_lock lock(stats_mutex_);
+        active_method_ = method;
+        active_unit_ = it->second;
+    }
+
+    if (previous != method && is_streaming(previous)) {
+        release_unit(previous);
+    }
+}
+
+void ScreencapAgent::release_unit(Method method)
+{
+    auto it = units_.find(method);
+    if (it == units_.end()) {
+        return;
+    }
+
+    LogInfo << "release screencap unit" << method;
+
+    std::erase(children_, std::static_pointer_cast<UnitBase>(it->second));
+    units_.erase(it);
+}
+
+bool ScreencapAgent::is_streaming(Method method)
+{
+    return method == Method::RawStream || method == Method::MinicapStream;
+}
+
+std::string ScreencapAgent::method_name(Method method)
+{
+    switch (method) {
+    case Method::EncodeToFileAndPull:
+        return "EncodeToFileAndPull";
+    case Method::Encode:
+        return "Encode";
+    case Method::RawWithGzip:
+        return "RawWithGzip";
+    case Method::RawByNetcat:
+        return "RawByNetcat";
+    case Method::RawStream:
+        return "RawStream";
+    case Method::MinicapDirect:
+        return "MinicapDirect";
+    case Method::MinicapStream:
+        return "MinicapStream";
+    case Method::MuMuPlayerExtras:
+        return "MuMuPlayerExtras";
+    case Method::LDPlayerExtras:
+        return "LDPlayerExtras";
+    case Method::AVDExtras:
+        return "AVDExtras";
+    default:
+        return "UnknownYet";
+    }
 }
 
 MAA_CTRL_UNIT_NS_END
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include <unordered_set>
 
 #include "Base/UnitBase.h"
@@ -18,6 +21,7 @@ public:
         Encode,
         RawWithGzip,
         RawByNetcat,
+        RawStream,
         MinicapDirect,
         MinicapStream,
         MuMuPlayerExtras,
@@ -42,11 +46,47 @@ public: // from ControlUnitSink
     virtual void on_app_started(const std::string& intent) override;
     virtual void on_app_stopped(const std::string& intent) override;
 
+public:
+    // 当前使用的方式和各方式最近的耗时、失败统计
+    json::object get_info() const;
+
 private:
-    std::shared_ptr<ScreencapBase> speed_test();
+    // 每种方式最近 kWindowSize 次截图的结果
+    struct MethodStats
+    {
+        static constexpr size_t kWindowSize = 16;
+
+        std::deque<std::optional<std::chrono::milliseconds>> window; // nullopt 表示失败
+        uint64_t total = 0;
+        uint64_t failed = 0;
+
+        void record(std::optional<std::chrono::milliseconds> cost);
+        std::optional<std::chrono::milliseconds> median() const;
+        size_t recent_failures() const;
+        json::object to_json() const;
+    };
+
+    Method speed_test();
+
+    std::optional<cv::Mat> screencap_by(Method method);
+    std::optional<Method> next_probe_method();
+    std::vector<Method> ranked_methods() const;
+    void maybe_switch();
+    void switch_to(Method method, std::string_view reason);
+    void release_unit(Method method);
+
+    static std::string method_name(Method method);
+    // 在设备上常驻截图进程、本地常驻读取线程的方式，不用时也在持续消耗
+    static bool is_streaming(Method method);
 
     std::unordered_map<Method, std::shared_ptr<ScreencapBase>> units_;
     std::shared_ptr<ScreencapBase> active_unit_;
+    Method active_method_ = Method::UnknownYet;
+
+    mutable std::mutex stats_mutex_;
+    std::unordered_map<Method, MethodStats> stats_;
+    uint64_t screencap_count_ = 0;
+    size_t probe_cursor_ = 0;
 };
 
 MAA_CTRL_UNIT_NS_END
@@ -57,7 +57,8 @@ std::optional<cv::Mat> MinicapStream::screencap()
     using namespace std::chrono_literals;
     cond_.wait_for(locker, 2s); // 等下一帧
 
-    return image_.empty() ? std::nullopt : std::make_optional(image_.clone());
+    // pulling 每帧都解码到新的 Mat 再整体替换 image_，这里直接共享即可
+    return image_.empty() ? std::nullopt : std::make_optional(image_);
 }
 
 std::optional<std::string> MinicapStream::read(size_t count)
@@ -0,0 +1,194 @@
+#include "RawStream.h"
+
+#include "MaaUtils/Logger.h"
+#include "MaaUtils/NoWarningCV.hpp"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+namespace
+{
+// 每帧前面输出的分隔符，用来测帧长和在出错时重新对齐
+constexpr std::string_view kFrameFlag = "MAA_RAW_FRAME\n";
+} // namespace
+
+ScreencapRawStream::~ScreencapRawStream()
+{
+    release_thread();
+    stop_stream();
+}
+
+bool ScreencapRawStream::parse(const json::value& config)
+{
+    static const json::array kDefaultScreencapRawStreamArgv = {
+        "{ADB}", "-s", "{ADB_SERIAL}", "exec-out", "while true; do echo MAA_RAW_FRAME; screencap; done",
+    };
+
+    return parse_command("ScreencapRawStream", config, kDefaultScreencapRawStreamArgv, stream_argv_);
+}
+
+bool ScreencapRawStream::init()
+{
+    LogFunc;
+
+    if (!start_stream()) {
+        return false;
+    }
+    quit_ = false;
+
+    // 先同步读一帧，确认设备端循环能正常出图
+    auto data_opt = read_frame();
+    auto img_opt = data_opt ? ScreencapHelper::decode_raw(*data_opt) : std::nullopt;
+    if (!img_opt) {
+        LogError << "failed to read first frame";
+        quit_ = true;
+        stop_stream();
+        return false;
+    }
+    image_ = std::move(*img_opt);
+
+    pull_thread_ = std::thread(std::bind(&ScreencapRawStream::pulling, this));
+
+    return true;
+}
+
+std::optional<cv::Mat> ScreencapRawStream::screencap()
+{
+    std::unique_lock locker(mutex_);
+    if (quit_) {
+        return std::nullopt;
+    }
+
+    using namespace std::chrono_literals;
+    cond_.wait_for(locker, 2s); // 等下一帧
+
+    // pulling 每帧都解码到新的 Mat 再整体替换 image_，这里直接共享即可
+    return image_.empty() ? std::nullopt : std::make_optional(image_);
+}
+
+bool ScreencapRawStream::start_stream()
+{
+    stop_stream();
+
+    auto argv_opt = stream_argv_.gen(argv_replace_);
+    if (!argv_opt) {
+        return false;
+    }
+
+    pipe_ios_ = std::make_shared<ChildPipeIOStream>(argv_opt->exec, argv_opt->args);
+    frame_size_ = 0;
+    return true;
+}
+
+void ScreencapRawStream::stop_stream()
+{
+    if (pipe_ios_) {
+        pipe_ios_->release();
+        pipe_ios_ = nullptr;
+    }
+}
+
+void ScreencapRawStream::release_thread()
+{
+    quit_ = true;
+    cond_.notify_all();
+    if (pull_thread_.joinable()) {
+        pull_thread_.join();
+    }
+}
+
+std::optional<std::string> ScreencapRawStream::read_exact(size_t count)
+{
+    using namespace std::chrono_literals;
+    constexpr auto kTimeout = 10s;
+
+    std::string result;
+    result.reserve(count);
+    auto start_time = std::chrono::steady_clock::now();
+
+    while (result.size() < count) {
+        // 分小段等，析构时不至于卡太久
+        std::string chunk = pipe_ios_->read_some(count - result.size(), 500ms);
+        if (chunk.empty()) {
+            if (quit_) {
+                return std::nullopt;
+            }
+            if (!pipe_ios_->running() || std::chrono::steady_clock::now() - start_time > kTimeout) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        result.append(chunk);
+    }
+    return result;
+}
+
+std::optional<std::string> ScreencapRawStream::read_frame()
+{
+    if (!pipe_ios_) {
+        return std::nullopt;
+    }
+
+    using namespace std::chrono_literals;
+
+    if (frame_size_ == 0) {
+        // 帧长未知（刚启动或分辨率变了）：先对齐到分隔符，再读到下一个分隔符，中间就是一整帧
+        if (!pipe_ios_->read_until(kFrameFlag, 10s).ends_with(kFrameFlag)) {
+            LogError << "failed to find frame flag";
+            return std::nullopt;
+        }
+        std::string data = pipe_ios_->read_until(kFrameFlag, 10s);
+        if (!data.ends_with(kFrameFlag)) {
+            LogError << "failed to measure frame size";
+            return std::nullopt;
+        }
+        data.resize(data.size() - kFrameFlag.size());
+        frame_size_ = data.size();
+        LogInfo << VAR(frame_size_);
+        return data;
+    }
+
+    auto data_opt = read_exact(frame_size_);
+    auto flag_opt = data_opt ? read_exact(kFrameFlag.size()) : std::nullopt;
+    if (!flag_opt || *flag_opt != kFrameFlag) {
+        LogWarn << "frame not aligned, re-measure" << VAR(frame_size_);
+        frame_size_ = 0;
+        return std::nullopt;
+    }
+    return data_opt;
+}
+
+void ScreencapRawStream::pulling()
+{
+    LogFunc;
+
+    using namespace std::chrono_literals;
+
+    while (!quit_) {
+        auto data_opt = read_frame();
+        if (quit_) {
+            break;
+        }
+
+        auto img_opt = data_opt ? ScreencapHelper::decode_raw(*data_opt) : std::nullopt;
+        if (!img_opt) {
+            LogError << "read or decode frame failed";
+            {
+                std::unique_lock locker(mutex_);
+                image_ = cv::Mat();
+            }
+
+            if (!pipe_ios_ || !pipe_ios_->running()) {
+                LogWarn << "stream exited, restart";
+                std::this_thread::sleep_for(1s);
+                start_stream();
+            }
+            continue;
+        }
+
+        std::unique_lock locker(mutex_);
+        image_ = std::move(*img_opt);
+        cond_.notify_all();
+    }
+}
+
+MAA_CTRL_UNIT_NS_END
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Base/UnitBase.h"
+#include "MaaUtils/IOStream/ChildPipeIOStream.h"
+
+#include "Common/Conf.h"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+// 设备端常驻一个 screencap 循环，通过同一个 exec-out 管道连续输出 raw 帧，
+// 后台线程解码最新一帧。效果类似 MinicapStream，但不需要 minicap，且是无损的
+class ScreencapRawStream : public ScreencapBase
+{
+public:
+    virtual ~ScreencapRawStream() override;
+
+public: // from UnitBase
+    virtual bool parse(const json::value& config) override;
+
+public: // from ScreencapBase
+    virtual bool init() override;
+    virtual std::optional<cv::Mat> screencap() override;
+
+private:
+    bool start_stream();
+    void stop_stream();
+    void release_thread();
+
+    std::optional<std::string> read_exact(size_t count);
+    std::optional<std::string> read_frame();
+
+    void pulling();
+
+    ProcessArgvGenerator stream_argv_;
+
+    std::shared_ptr<ChildPipeIOStream> pipe_ios_ = nullptr;
+    // 每帧 raw 数据（头 + 像素）的长度，0 表示还没测出来，下一帧要重新按分隔符测
+    size_t frame_size_ = 0;
+
+    std::atomic_bool quit_ = true;
+    std::mutex mutex_;
+    cv::Mat image_;
+    std::condition_variable cond_;
+    std::thread pull_thread_;
+};
+
+MAA_CTRL_UNIT_NS_END
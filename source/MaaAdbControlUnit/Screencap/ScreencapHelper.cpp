@@ -1,17 +1,13 @@
 #include "ScreencapHelper.h"
 
+#include <array>
+#include <cstring>
+
+#include <zlib.h>
+
 #include "MaaUtils/Logger.h"
 #include "MaaUtils/NoWarningCV.hpp"
 
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable: 4068)
-#endif
-#include <gzip/decompress.hpp>
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
-
 MAA_CTRL_UNIT_NS_BEGIN
 
 std::optional<cv::Mat>
@@ -105,23 +101,78 @@ std::optional<cv::Mat> ScreencapHelper::decode_raw(const std::string& buffer)
     size_t header_size = buffer.size() - size;
     const uint8_t* im_data = data + header_size;
 
+    // 只是引用 buffer，cvtColor 会输出到新的 Mat，不用再 clone
     cv::Mat temp(im_height, im_width, CV_8UC4, const_cast<uint8_t*>(im_data));
-    if (temp.empty()) {
+    return rgba_to_bgr(temp);
+}
+
+std::optional<cv::Mat> ScreencapHelper::decode_gzip(const std::string& buffer)
+{
+    // gzip 最小 18 字节（10 字节头 + 8 字节尾）
+    if (buffer.size() < 18) {
         return std::nullopt;
     }
 
-    const auto& br = *(temp.end<cv::Vec4b>() - 1);
-    if (br[3] != 255) { // only check alpha
+    // gzip 尾部 4 字节是解压后的总长度，据此直接分好 Mat，像素解压进去，不经过中间的 string
+    uint32_t raw_size = 0;
+    memcpy(&raw_size, buffer.data() + buffer.size() - 4, 4);
+
+    z_stream zs {};
+    if (inflateInit2(&zs, 15 + 16) != Z_OK) {
+        LogError << "inflateInit2 failed";
         return std::nullopt;
     }
-    cv::cvtColor(temp, temp, cv::COLOR_RGBA2BGR);
-    return temp.clone(); // temp只是引用data, 需要clone确保数据拥有所有权
-}
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(buffer.data()));
+    zs.avail_in = static_cast<uInt>(buffer.size());
+
+    auto inflate_to = [&zs](void* dst, size_t size) {
+        zs.next_out = static_cast<Bytef*>(dst);
+        zs.avail_out = static_cast<uInt>(size);
+        while (zs.avail_out > 0) {
+            int ret = inflate(&zs, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                break;
+            }
+            if (ret != Z_OK) {
+                return false;
+            }
+        }
+        return zs.avail_out == 0;
+    };
 
-std::optional<cv::Mat> ScreencapHelper::decode_gzip(const std::string& buffer)
-{
-    auto buf = gzip::decompress(buffer.c_str(), buffer.size());
-    return decode_raw(buf);
+    auto decode = [&]() -> std::optional<cv::Mat> {
+        std::array<uint32_t, 2> size_header {};
+        if (!inflate_to(size_header.data(), sizeof(size_header))) {
+            return std::nullopt;
+        }
+        const auto [im_width, im_height] = size_header;
+
+        size_t size = 4ull * im_width * im_height;
+        if (size == 0 || raw_size < size + sizeof(size_header)) {
+            LogError << "invalid raw size" << VAR(raw_size) << VAR(im_width) << VAR(im_height);
+            return std::nullopt;
+        }
+
+        // 剩下的头（format、colorspace 等）丢掉
+        std::array<uint8_t, 64> skipped {};
+        for (size_t rest = raw_size - size - sizeof(size_header); rest > 0;) {
+            size_t n = std::min(rest, skipped.size());
+            if (!inflate_to(skipped.data(), n)) {
+                return std::nullopt;
+            }
+            rest -= n;
+        }
+
+        cv::Mat rgba(static_cast<int>(im_height), static_cast<int>(im_width), CV_8UC4);
+        if (!inflate_to(rgba.data, size)) {
+            return std::nullopt;
+        }
+        return rgba_to_bgr(rgba);
+    };
+
+    auto result = decode();
+    inflateEnd(&zs);
+    return result;
 }
 
 std::optional<cv::Mat> ScreencapHelper::decode_png(const std::string& buffer)
@@ -153,38 +204,64 @@ std::optional<cv::Mat> ScreencapHelper::decode(const std::string& buffer)
     return img.empty() ? std::nullopt : std::make_optional(img);
 }
 
+std::optional<cv::Mat> ScreencapHelper::rgba_to_bgr(const cv::Mat& rgba)
+{
+    if (rgba.empty()) {
+        return std::nullopt;
+    }
+
+    const auto& br = *(rgba.end<cv::Vec4b>() - 1);
+    if (br[3] != 255) { // only check alpha
+        return std::nullopt;
+    }
+
+    cv::Mat bgr;
+    cv::cvtColor(rgba, bgr, cv::COLOR_RGBA2BGR);
+    return bgr;
+}
+
 bool ScreencapHelper::clean_cr(std::string& buffer)
 {
     if (buffer.size() < 2) {
         return false;
     }
 
-    auto check = [](std::string::iterator it) {
-        return *it == '\r' && *(it + 1) == '\n';
-    };
+    // 用 memchr 找 \r（libc 里是向量化的），两个 \r\n 之间的整段用 memmove 搬，不再逐字节改写
+    char* const begin = buffer.data();
+    const char* const end = begin + buffer.size();
 
-    auto scan = buffer.end();
-    for (auto it = buffer.begin(); it != buffer.end() - 1; ++it) {
-        if (check(it)) {
-            scan = it;
-            break;
+    auto find_crlf = [end](const char* from) -> const char* {
+        while (from < end - 1) {
+            auto cr = static_cast<const char*>(memchr(from, '\r', end - 1 - from));
+            if (!cr) {
+                return nullptr;
+            }
+            if (cr[1] == '\n') {
+                return cr;
+            }
+            from = cr + 1;
         }
-    }
-    if (scan == buffer.end()) {
+        return nullptr;
+    };
+
+    const char* crlf = find_crlf(begin);
+    if (!crlf) {
         return false;
     }
 
-    auto last = buffer.end() - 1;
-    auto ptr = scan;
-    while (++scan != last) {
-        if (!check(scan)) {
-            *ptr = *scan;
-            ++ptr;
-        }
+    char* write = const_cast<char*>(crlf);
+    const char* read = crlf + 1; // 跳过 \r
+    while ((crlf = find_crlf(read))) {
+        size_t n = crlf - read;
+        memmove(write, read, n);
+        write += n;
+        read = crlf + 1;
     }
-    *ptr = *last;
-    ++ptr;
-    buffer.erase(ptr, buffer.end());
+    size_t n = end - read;
+    memmove(write, read, n);
+    write += n;
+
+    buffer.resize(write - begin);
     return true;
 }
 
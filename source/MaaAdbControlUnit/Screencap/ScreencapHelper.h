@@ -22,6 +22,7 @@ public:
     static std::optional<cv::Mat> decode(const std::string& buffer);
 
 private:
+    static std::optional<cv::Mat> rgba_to_bgr(const cv::Mat& rgba);
     static bool clean_cr(std::string& buffer);
     static bool check_head_tail(std::string_view input, std::string_view head, std::string_view tail);
 
@@ -419,6 +419,9 @@ bool AgentClient::handle_inserted_request(const json::value& j)
     else if (handle_resource_get_default_action_param(j)) {
         return true;
     }
+    else if (handle_resource_get_ocr_session_pool_stats(j)) {
+        return true;
+    }
 
     else if (handle_controller_post_connection(j)) {
         return true;
@@ -1867,6 +1870,29 @@ bool AgentClient::handle_resource_get_default_action_param(const json::value& j)
     return true;
 }
 
+bool AgentClient::handle_resource_get_ocr_session_pool_stats(const json::value& j)
+{
+    if (!j.is<ResourceGetOCRSessionPoolStatsReverseRequest>()) {
+        return false;
+    }
+
+    const ResourceGetOCRSessionPoolStatsReverseRequest& req = j.as<ResourceGetOCRSessionPoolStatsReverseRequest>();
+    LogFunc << VAR(req) << VAR(ipc_addr_);
+
+    MaaResource* resource = query_resource(req.resource_id);
+    if (!resource) {
+        LogError << "resource not found" << VAR(req.resource_id);
+        return false;
+    }
+
+    ResourceGetOCRSessionPoolStatsReverseResponse resp {
+        .stats = resource->get_ocr_session_pool_stats(),
+    };
+    send(resp);
+
+    return true;
+}
+
 bool AgentClient::handle_controller_post_connection(const json::value& j)
 {
     if (!j.is<ControllerPostConnectionReverseRequest>()) {
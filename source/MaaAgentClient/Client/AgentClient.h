@@ -95,6 +95,7 @@ private:
     bool handle_resource_get_custom_action_list(const json::value& j);
     bool handle_resource_get_default_recognition_param(const json::value& j);
     bool handle_resource_get_default_action_param(const json::value& j);
+    bool handle_resource_get_ocr_session_pool_stats(const json::value& j);
 
     bool handle_controller_post_connection(const json::value& j);
     bool handle_controller_post_click(const json::value& j);
@@ -300,6 +300,20 @@ std::optional<json::object> RemoteResource::get_default_action_param(const std::
     return resp_opt->param;
 }
 
+json::object RemoteResource::get_ocr_session_pool_stats() const
+{
+    ResourceGetOCRSessionPoolStatsReverseRequest req {
+        .resource_id = resource_id_,
+    };
+
+    auto resp_opt = server_.send_and_recv<ResourceGetOCRSessionPoolStatsReverseResponse>(req);
+    if (!resp_opt) {
+        return { };
+    }
+
+    return resp_opt->stats;
+}
+
 MaaSinkId RemoteResource::add_sink(MaaEventCallback callback, void* trans_arg)
 {
     LogError << "Can NOT add sink for remote instance, use AgentServer.add_resource_sink instead" << VAR_VOIDP(callback)
@@ -46,6 +46,8 @@ public:
     virtual std::optional<json::object> get_default_recognition_param(const std::string& reco_type) const override;
     virtual std::optional<json::object> get_default_action_param(const std::string& action_type) const override;
 
+    virtual json::object get_ocr_session_pool_stats() const override;
+
     virtual MaaSinkId add_sink(MaaEventCallback callback, void* trans_arg) override;
     virtual void remove_sink(MaaSinkId sink_id) override;
     virtual void clear_sinks() override;
@@ -14,6 +14,7 @@ bool CarouselImage::connect()
     connected_ = false;
     images_.clear();
     image_index_ = 0;
+    region_screencap_count_ = 0;
 
     if (!std::filesystem::exists(path_)) {
         LogError << VAR(path_) << "not exists";
@@ -98,6 +99,24 @@ bool CarouselImage::screencap(cv::Mat& image)
     return true;
 }
 
+bool CarouselImage::screencap_region(const cv::Rect& roi, cv::Mat& image)
+{
+    // 和整图截图一样轮到下一张，只是裁出 roi 交出去
+    cv::Mat full;
+    if (!screencap(full)) {
+        return false;
+    }
+
+    if ((roi & cv::Rect(0, 0, full.cols, full.rows)) != roi) {
+        LogError << "roi out of image" << VAR(roi) << VAR(full.cols) << VAR(full.rows);
+        return false;
+    }
+
+    image = full(roi).clone();
+    ++region_screencap_count_;
+    return true;
+}
+
 bool CarouselImage::click(int x, int y)
 {
     std::ignore = x;
@@ -178,6 +197,7 @@ json::object CarouselImage::get_info() const
     info["path"] = path_to_utf8_string(path_);
     info["image_count"] = static_cast<int64_t>(images_.size());
     info["image_index"] = static_cast<int64_t>(image_index_);
+    info["region_screencap_count"] = static_cast<int64_t>(region_screencap_count_);
     return info;
 }
 
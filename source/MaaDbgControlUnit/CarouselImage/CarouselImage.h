@@ -32,6 +32,10 @@ public: // from ControlUnitAPI
 
     virtual bool screencap(/*out*/ cv::Mat& image) override;
 
+    virtual bool support_screencap_region() const override { return true; }
+
+    virtual bool screencap_region(const cv::Rect& roi, /*out*/ cv::Mat& image) override;
+
     virtual bool click(int x, int y) override;
     virtual bool swipe(int x1, int y1, int x2, int y2, int duration) override;
 
@@ -53,6 +57,7 @@ private:
     std::filesystem::path path_;
     std::vector<cv::Mat> images_;
     size_t image_index_ = 0;
+    size_t region_screencap_count_ = 0;
     cv::Size resolution_ { };
     bool connected_ = false;
 };
@@ -1,5 +1,8 @@
 #include "ControllerAgent.h"
 
+#include <numeric>
+
+#include "FrameResize.h"
 #include "Global/OptionMgr.h"
 #include "Global/PluginMgr.h"
 #include "MaaFramework/MaaMsg.h"
@@ -28,6 +31,8 @@ ControllerAgent::ControllerAgent(std::shared_ptr<MAA_CTRL_UNIT_NS::ControlUnitAP
 ControllerAgent::~ControllerAgent()
 {
     LogFunc;
+
+    stop_continuous_screencap();
 }
 
 bool ControllerAgent::set_option(MaaCtrlOption key, MaaOptionValue value, MaaOptionValueSize val_size)
@@ -41,6 +46,8 @@ bool ControllerAgent::set_option(MaaCtrlOption key, MaaOptionValue value, MaaOpt
         return set_image_target_short_side(value, val_size);
     case MaaCtrlOption_ScreenshotUseRawSize:
         return set_image_use_raw_size(value, val_size);
+    case MaaCtrlOption_ContinuousScreencap:
+        return set_continuous_screencap(value, val_size);
 
     default:
         LogError << "Unknown key" << VAR(key) << VAR(value);
@@ -201,8 +208,9 @@ bool ControllerAgent::connected() const
 
 cv::Mat ControllerAgent::cached_image() const
 {
+    // 帧缓冲区只在没有外部引用时才会被复用，这里给出去的引用在使用期间内容不会变
     std::unique_lock lock(image_mutex_);
-    return image_.clone();
+    return image_;
 }
 
 std::string ControllerAgent::cached_shell_output() const
@@ -256,6 +264,11 @@ void ControllerAgent::post_stop()
 
     need_to_stop_ = true;
 
+    {
+        std::unique_lock lock(frames_mutex_);
+    }
+    frames_cond_.notify_all();
+
     if (action_runner_ && action_runner_->running()) {
         action_runner_->clear();
     }
@@ -346,11 +359,41 @@ bool ControllerAgent::input_text(InputTextParam p)
 
 cv::Mat ControllerAgent::screencap()
 {
-    auto id = post({ .type = Action::Type::screencap });
+    return screencap_frame().image;
+}
+
+ScreencapFrame ControllerAgent::screencap_frame()
+{
+    return screencap_frame(cv::Rect { });
+}
+
+ScreencapFrame ControllerAgent::screencap_frame(const cv::Rect& roi)
+{
+    // 后台连续截图出的都是整图，能用就直接用
+    if (continuous_max_age_ms_ > 0) {
+        if (auto frame = wait_continuous_frame()) {
+            return *std::move(frame);
+        }
+        LogWarn << "continuous screencap timeout, fallback to one-shot";
+    }
+
+    ScreencapParam param;
+    if (!roi.empty() && control_unit_ && control_unit_->support_screencap_region()) {
+        param.roi = roi;
+        param.region_frame = std::make_shared<ScreencapFrame>();
+    }
+
+    auto id = post({ .type = Action::Type::screencap, .param = param });
     if (wait(id) != MaaStatus_Succeeded) {
         return { };
     }
-    return cached_image();
+
+    if (param.region_frame && !param.region_frame->image.empty()) {
+        return *param.region_frame;
+    }
+
+    std::unique_lock lock(image_mutex_);
+    return ScreencapFrame { .image = image_, .fingerprint = fingerprint_ };
 }
 
 bool ControllerAgent::start_app(AppParam p)
@@ -784,13 +827,17 @@ bool ControllerAgent::handle_input_text(const InputTextParam& param)
     return ret;
 }
 
-bool ControllerAgent::handle_screencap()
+bool ControllerAgent::handle_screencap(const ScreencapParam& param)
 {
     if (!control_unit_) {
         LogError << "control_unit_ is nullptr";
         return false;
     }
 
+    if (!param.roi.empty() && param.region_frame && handle_screencap_region(param.roi, *param.region_frame)) {
+        return true;
+    }
+
     cv::Mat raw_image;
     bool screencaped = control_unit_->screencap(raw_image);
     if (!screencaped) {
@@ -803,6 +850,50 @@ bool ControllerAgent::handle_screencap()
     return ret;
 }
 
+bool ControllerAgent::handle_screencap_region(const cv::Rect& roi, ScreencapFrame& frame)
+{
+    // 还不知道分辨率，先截一次整图
+    if (image_raw_width_ == 0 || image_raw_height_ == 0 || image_target_width_ == 0 || image_target_height_ == 0) {
+        return false;
+    }
+
+    // 区域按缩放的最小整数周期对齐（如 1080p -> 720p 时原图 3 像素对应 2 像素），
+    // 这样缩放出来的像素和整图缩放后对应位置完全一致，识别结果不受影响
+    const int gcd_w = std::gcd(image_raw_width_, image_target_width_);
+    const int gcd_h = std::gcd(image_raw_height_, image_target_height_);
+    const int target_step_x = image_target_width_ / gcd_w;
+    const int target_step_y = image_target_height_ / gcd_h;
+    const int raw_step_x = image_raw_width_ / gcd_w;
+    const int raw_step_y = image_raw_height_ / gcd_h;
+
+    const cv::Rect clamped = roi & cv::Rect(0, 0, image_target_width_, image_target_height_);
+    if (clamped.empty()) {
+        return false;
+    }
+
+    const int x0 = clamped.x / target_step_x;
+    const int y0 = clamped.y / target_step_y;
+    const int x1 = (clamped.br().x + target_step_x - 1) / target_step_x;
+    const int y1 = (clamped.br().y + target_step_y - 1) / target_step_y;
+
+    const cv::Rect target_roi(x0 * target_step_x, y0 * target_step_y, (x1 - x0) * target_step_x, (y1 - y0) * target_step_y);
+    const cv::Rect raw_roi(x0 * raw_step_x, y0 * raw_step_y, (x1 - x0) * raw_step_x, (y1 - y0) * raw_step_y);
+
+    // 对齐后差不多是整屏了，区域截图就没什么收益
+    if (raw_roi.area() * 2 > image_raw_width_ * image_raw_height_) {
+        LogDebug << "region too large, use full screencap" << VAR(roi) << VAR(raw_roi);
+        return false;
+    }
+
+    cv::Mat raw_image;
+    if (!control_unit_->screencap_region(raw_roi, raw_image) || raw_image.size() != raw_roi.size()) {
+        LogWarn << "region screencap failed, fallback to full screencap" << VAR(raw_roi) << VAR(raw_image.cols) << VAR(raw_image.rows);
+        return false;
+    }
+
+    return postproc_region(raw_image, raw_roi, target_roi, frame);
+}
+
 bool ControllerAgent::handle_start_app(const AppParam& param)
 {
     if (!control_unit_) {
@@ -953,6 +1044,15 @@ bool ControllerAgent::run_action(typename AsyncRunner<Action>::Id id, Action act
         notifier_.notify(this, MaaMsg_Controller_Action_Starting, cb_detail);
     }
 
+    std::unique_lock unit_lock(control_unit_mutex_);
+
+    if (action.type != Action::Type::screencap) {
+        // 操作之后画面可能变了，之前截的帧不能再给出去
+        std::unique_lock lock(frames_mutex_);
+        ++input_generation_;
+        frames_.clear();
+    }
+
     switch (action.type) {
     case Action::Type::connect:
         ret = handle_connect();
@@ -999,9 +1099,10 @@ bool ControllerAgent::run_action(typename AsyncRunner<Action>::Id id, Action act
         ret = handle_key_up(std::get<ClickKeyParam>(action.param));
         break;
 
-    case Action::Type::screencap:
-        ret = handle_screencap();
-        break;
+    case Action::Type::screencap: {
+        const auto* param = std::get_if<ScreencapParam>(&action.param);
+        ret = handle_screencap(param ? *param : ScreencapParam { });
+    } break;
 
     case Action::Type::start_app:
         ret = handle_start_app(std::get<AppParam>(action.param));
@@ -1031,6 +1132,8 @@ bool ControllerAgent::run_action(typename AsyncRunner<Action>::Id id, Action act
         ret = false;
     }
 
+    unit_lock.unlock();
+
     if (ret && notify) {
         notifier_.notify(this, MaaMsg_Controller_Action_Succeeded, cb_detail);
     }
@@ -1067,7 +1170,9 @@ cv::Point ControllerAgent::preproc_touch_point(const cv::Point& p)
 bool ControllerAgent::postproc_screenshot(const cv::Mat& raw)
 {
     if (raw.empty()) {
+        std::unique_lock lock(image_mutex_);
         image_ = cv::Mat();
+        fingerprint_ = nullptr;
         LogError << "Empty screenshot";
         return false;
     }
@@ -1079,16 +1184,65 @@ bool ControllerAgent::postproc_screenshot(const cv::Mat& raw)
         image_raw_height_ = raw.rows;
 
         if (!calc_target_image_size()) {
+            std::unique_lock lock(image_mutex_);
             image_ = cv::Mat();
+            fingerprint_ = nullptr;
             LogError << "Invalid target image size";
             return false;
         }
     }
 
-    cv::resize(raw, image_, { image_target_width_, image_target_height_ }, 0, 0, cv::INTER_AREA);
+    const cv::Size target_size(image_target_width_, image_target_height_);
+    cv::Mat image = acquire_frame_buffer(target_size, raw.type());
+    resize_area(raw, image, target_size);
+    auto fingerprint = FrameFingerprint::make(image);
+
+    std::unique_lock lock(image_mutex_);
+    image_ = std::move(image);
+    fingerprint_ = std::move(fingerprint);
     return !image_.empty();
 }
 
+bool ControllerAgent::postproc_region(const cv::Mat& raw, const cv::Rect& raw_roi, const cv::Rect& target_roi, ScreencapFrame& frame)
+{
+    const cv::Size target_size(image_target_width_, image_target_height_);
+    cv::Mat image = acquire_frame_buffer(target_size, raw.type());
+    // 复用的缓冲区里是旧帧，区域外统一清成黑的，免得被当成当前画面
+    image.setTo(cv::Scalar::all(0));
+
+    cv::Mat dst = image(target_roi);
+    resize_area(raw, dst, target_roi.size());
+
+    LogDebug << "region screencap" << VAR(raw_roi) << VAR(target_roi);
+
+    // image_ 保持上一张整图不动，cached_image()、save_on_error 等拿到的都是完整的画面
+    frame.fingerprint = FrameFingerprint::make(image);
+    frame.image = std::move(image);
+    frame.partial = true;
+    return !frame.image.empty();
+}
+
+cv::Mat ControllerAgent::acquire_frame_buffer(const cv::Size& size, int type)
+{
+    // 当前帧（image_）和还被识别、帧队列拿着的旧帧引用计数都大于 1，不会被选中
+    constexpr size_t kMaxFrameBuffers = 6;
+
+    std::erase_if(frame_buffers_, [&](const cv::Mat& buffer) { return buffer.size() != size || buffer.type() != type; });
+
+    for (const cv::Mat& buffer : frame_buffers_) {
+        // 别的线程释放帧时用 CV_XADD 原子地改引用计数，这里也要原子读
+        if (buffer.u && CV_XADD(&buffer.u->refcount, 0) == 1) {
+            return buffer;
+        }
+    }
+
+    cv::Mat buffer(size, type);
+    if (frame_buffers_.size() < kMaxFrameBuffers) {
+        frame_buffers_.emplace_back(buffer);
+    }
+    return buffer;
+}
+
 bool ControllerAgent::calc_target_image_size()
 {
     if (image_raw_width_ == 0 || image_raw_height_ == 0) {
@@ -1161,7 +1315,137 @@ bool ControllerAgent::request_uuid()
 bool ControllerAgent::init_scale_info()
 {
     // 实际是通过 postproc_screenshot 初始化的
-    return handle_screencap();
+    return handle_screencap({ });
+}
+
+void ControllerAgent::start_continuous_screencap()
+{
+    LogFunc;
+
+    stop_continuous_screencap();
+
+    {
+        std::unique_lock lock(frames_mutex_);
+        frames_.clear();
+        capture_failed_ = false;
+        last_request_time_ = std::chrono::steady_clock::now();
+    }
+
+    capture_exit_ = false;
+    capture_thread_ = std::thread(&ControllerAgent::continuous_screencap_loop, this);
+}
+
+void ControllerAgent::stop_continuous_screencap()
+{
+    if (!capture_thread_.joinable()) {
+        return;
+    }
+
+    LogFunc;
+
+    {
+        std::unique_lock lock(frames_mutex_);
+        capture_exit_ = true;
+    }
+    frames_cond_.notify_all();
+    capture_thread_.join();
+
+    std::unique_lock lock(frames_mutex_);
+    frames_.clear();
+}
+
+void ControllerAgent::continuous_screencap_loop()
+{
+    LogFunc;
+
+    // 超过这么久没人要图就停下来，避免空转占用设备
+    constexpr auto kIdleTimeout = std::chrono::seconds(2);
+    constexpr auto kRetryInterval = std::chrono::milliseconds(100);
+    constexpr size_t kFrameRingSize = 3;
+
+    while (!capture_exit_) {
+        {
+            std::unique_lock lock(frames_mutex_);
+            frames_cond_.wait(lock, [&]() {
+                return capture_exit_ || std::chrono::steady_clock::now() - last_request_time_ < kIdleTimeout;
+            });
+        }
+        if (capture_exit_) {
+            break;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+        ScreencapFrame frame { .time = start_time };
+        uint64_t generation = 0;
+        {
+            std::unique_lock unit_lock(control_unit_mutex_);
+            {
+                std::unique_lock lock(frames_mutex_);
+                generation = input_generation_;
+            }
+            cv::Mat raw;
+            if (connected() && control_unit_->screencap(raw) && postproc_screenshot(raw)) {
+                std::unique_lock image_lock(image_mutex_);
+                frame.image = image_;
+                frame.fingerprint = fingerprint_;
+            }
+        }
+
+        if (frame.image.empty()) {
+            {
+                std::unique_lock lock(frames_mutex_);
+                capture_failed_ = true;
+            }
+            frames_cond_.notify_all();
+            std::this_thread::sleep_for(kRetryInterval);
+            continue;
+        }
+
+        {
+            std::unique_lock lock(frames_mutex_);
+            capture_failed_ = false;
+            if (generation != input_generation_) {
+                LogDebug << "input happened during capture, drop frame";
+                continue;
+            }
+            frame.seq = ++frame_seq_;
+            frames_.emplace_back(std::move(frame));
+            while (frames_.size() > kFrameRingSize) {
+                frames_.pop_front();
+            }
+        }
+        frames_cond_.notify_all();
+    }
+}
+
+std::optional<ScreencapFrame> ControllerAgent::wait_continuous_frame()
+{
+    constexpr auto kWaitTimeout = std::chrono::seconds(10);
+
+    const auto request_time = std::chrono::steady_clock::now();
+    const auto max_age = std::chrono::milliseconds(continuous_max_age_ms_.load());
+
+    std::unique_lock lock(frames_mutex_);
+    last_request_time_ = request_time;
+    frames_cond_.notify_all();
+
+    // 每次都要拿到没给出去过的新帧，否则 wait_freezes 之类前后比图的逻辑会拿到同一帧
+    auto fresh = [&]() {
+        if (frames_.empty()) {
+            return false;
+        }
+        const auto& latest = frames_.back();
+        return latest.seq > last_taken_seq_ && request_time - latest.time <= max_age;
+    };
+    // 后台截图失败（如未连接）或要停止时不等，交给调用方单次截图，与不开连续截图时一样立刻失败
+    bool got = frames_cond_.wait_for(lock, kWaitTimeout, [&]() { return capture_exit_ || capture_failed_ || need_to_stop_ || fresh(); });
+
+    if (!got || capture_exit_ || !fresh()) {
+        return std::nullopt;
+    }
+
+    last_taken_seq_ = frames_.back().seq;
+    return frames_.back();
 }
 
 bool ControllerAgent::set_image_target_long_side(MaaOptionValue value, MaaOptionValueSize val_size)
@@ -1213,4 +1497,30 @@ bool ControllerAgent::set_image_use_raw_size(MaaOptionValue value, MaaOptionValu
     return true;
 }
 
+bool ControllerAgent::set_continuous_screencap(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogDebug;
+
+    if (val_size != sizeof(int)) {
+        LogError << "invalid value size: " << val_size;
+        return false;
+    }
+    int max_age = *reinterpret_cast<int*>(value);
+    if (max_age < 0) {
+        LogError << "invalid max age: " << max_age;
+        return false;
+    }
+
+    continuous_max_age_ms_ = max_age;
+    if (max_age > 0) {
+        start_continuous_screencap();
+    }
+    else {
+        stop_continuous_screencap();
+    }
+
+    LogInfo << "continuous screencap max age = " << max_age;
+    return true;
+}
+
 MAA_CTRL_NS_END
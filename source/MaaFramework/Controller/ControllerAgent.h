@@ -1,13 +1,20 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
+#include <thread>
 #include <variant>
 
 #include "Base/AsyncRunner.hpp"
 #include "Common/MaaTypes.h"
 #include "ControlUnit/ControlUnitAPI.h"
+#include "FrameFingerprint.h"
 #include "MaaUtils/JsonExt.hpp"
 #include "MaaUtils/NoWarningCVMat.hpp"
 #include "Utils/EventDispatcher.hpp"
@@ -123,6 +130,17 @@ struct ShellParam
     MEO_TOJSON(cmd, shell_timeout);
 };
 
+struct ScreencapFrame;
+
+struct ScreencapParam
+{
+    cv::Rect roi { }; // 只需要这块区域（目标分辨率坐标），为空时截整图
+    // 区域截图的结果只写到这里，不进 image_，免得 cached_image() 拿到大半是黑的图
+    std::shared_ptr<ScreencapFrame> region_frame = nullptr;
+
+    MEO_TOJSON(roi);
+};
+
 using Param = std::variant<
     std::monostate,
     ClickParam,
@@ -136,7 +154,8 @@ using Param = std::variant<
     AppParam,
     ScrollParam,
     ShellParam,
-    RelativeMoveParam>;
+    RelativeMoveParam,
+    ScreencapParam>;
 
 struct Action
 {
@@ -168,6 +187,16 @@ struct Action
     Param param;
 };
 
+// 一帧截图。seq 和 time 只有后台连续截图时才有
+struct ScreencapFrame
+{
+    uint64_t seq = 0;
+    std::chrono::steady_clock::time_point time; // 开始截图的时间
+    cv::Mat image;
+    std::shared_ptr<const FrameFingerprint> fingerprint = nullptr;
+    bool partial = false; // 区域截图，只有请求的 roi 内有效，也没有更新 cached_image()
+};
+
 class ControllerAgent : public MaaController
 {
 public:
@@ -240,6 +269,9 @@ public: // for Actuator
 
     bool input_text(InputTextParam p);
     cv::Mat screencap();
+    ScreencapFrame screencap_frame();
+    // 只保证 roi 内的内容有效，其余部分可能是黑的。控制器不支持区域截图时和 screencap_frame() 一样
+    ScreencapFrame screencap_frame(const cv::Rect& roi);
 
     bool start_app(AppParam p);
     bool stop_app(AppParam p);
@@ -260,7 +292,8 @@ private:
     bool handle_click_key(const ClickKeyParam& param);
     bool handle_long_press_key(const LongPressKeyParam& param);
     bool handle_input_text(const InputTextParam& param);
-    bool handle_screencap();
+    bool handle_screencap(const ScreencapParam& param);
+    bool handle_screencap_region(const cv::Rect& roi, ScreencapFrame& frame);
     bool handle_start_app(const AppParam& param);
     bool handle_stop_app(const AppParam& param);
     bool handle_key_down(const ClickKeyParam& param);
@@ -277,18 +310,27 @@ private:
     bool run_action(typename AsyncRunner<Action>::Id id, Action action);
     cv::Point preproc_touch_point(const cv::Point& p);
     bool postproc_screenshot(const cv::Mat& raw);
+    bool postproc_region(const cv::Mat& raw, const cv::Rect& raw_roi, const cv::Rect& target_roi, ScreencapFrame& frame);
+    cv::Mat acquire_frame_buffer(const cv::Size& size, int type);
     bool calc_target_image_size();
     void clear_target_image_size();
     bool request_uuid();
     bool init_scale_info();
 
+private: // continuous screencap
+    void start_continuous_screencap();
+    void stop_continuous_screencap();
+    void continuous_screencap_loop();
+    std::optional<ScreencapFrame> wait_continuous_frame();
+
 private: // options
     bool set_image_target_long_side(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_image_target_short_side(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_image_use_raw_size(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_continuous_screencap(MaaOptionValue value, MaaOptionValueSize val_size);
 
 private:
-    bool need_to_stop_ = false;
+    std::atomic_bool need_to_stop_ = false;
 
 private:
     const std::shared_ptr<MAA_CTRL_UNIT_NS::ControlUnitAPI> control_unit_ = nullptr;
@@ -296,6 +338,9 @@ private:
 
     mutable std::mutex image_mutex_;
     cv::Mat image_;
+    std::shared_ptr<const FrameFingerprint> fingerprint_ = nullptr;
+    // 缩放结果的缓冲区，没有被别人引用时才会被下一帧复用，所以交出去的图不用 clone
+    std::vector<cv::Mat> frame_buffers_;
     mutable std::mutex shell_output_mutex_;
     std::string shell_output_;
 
@@ -312,6 +357,21 @@ private:
     std::set<AsyncRunner<Action>::Id> focus_ids_;
     std::mutex focus_ids_mutex_;
     std::unique_ptr<AsyncRunner<Action>> action_runner_ = nullptr;
+
+    // action 线程和后台截图线程不能同时操作 control_unit_
+    std::mutex control_unit_mutex_;
+
+    std::atomic<int> continuous_max_age_ms_ = 0;
+    std::atomic_bool capture_exit_ = false;
+    std::thread capture_thread_;
+    std::mutex frames_mutex_;
+    std::condition_variable frames_cond_;
+    std::deque<ScreencapFrame> frames_;
+    bool capture_failed_ = false; // 后台最近一次截图失败，等帧的直接退回单次截图，不干等
+    uint64_t input_generation_ = 0; // 每次非截图操作 +1，之前开始截的帧都作废
+    uint64_t frame_seq_ = 0;
+    uint64_t last_taken_seq_ = 0;
+    std::chrono::steady_clock::time_point last_request_time_;
 };
 
 MAA_CTRL_NS_END
@@ -0,0 +1,98 @@
+#include "FrameFingerprint.h"
+
+#include <algorithm>
+#include <cstring>
+
+MAA_CTRL_NS_BEGIN
+
+namespace
+{
+constexpr uint64_t kFnvOffset = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+inline uint64_t mix(uint64_t h, uint64_t v)
+{
+    return (h ^ v) * kFnvPrime;
+}
+} // namespace
+
+std::shared_ptr<const FrameFingerprint> FrameFingerprint::make(const cv::Mat& image)
+{
+    if (image.empty() || image.depth() != CV_8U) {
+        return nullptr;
+    }
+
+    auto result = std::make_shared<FrameFingerprint>();
+    result->size = image.size();
+    result->grid = cv::Size((image.cols + kTileSize - 1) / kTileSize, (image.rows + kTileSize - 1) / kTileSize);
+    result->tiles.assign(static_cast<size_t>(result->grid.area()), kFnvOffset);
+
+    const size_t elem_size = image.elemSize();
+
+    // 按行扫，每行依次喂给所在的各个 tile，整张图只读一遍
+    for (int y = 0; y < image.rows; ++y) {
+        const uchar* row = image.ptr<uchar>(y);
+        uint64_t* row_tiles = result->tiles.data() + static_cast<size_t>(y / kTileSize) * result->grid.width;
+
+        for (int tx = 0; tx < result->grid.width; ++tx) {
+            const int x_begin = tx * kTileSize;
+            const int x_end = std::min(x_begin + kTileSize, image.cols);
+            const uchar* p = row + x_begin * elem_size;
+            const size_t bytes = (x_end - x_begin) * elem_size;
+
+            uint64_t h = row_tiles[tx];
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+                uint64_t v = 0;
+                std::memcpy(&v, p + i, sizeof(v));
+                h = mix(h, v);
+            }
+            for (; i < bytes; ++i) {
+                h = mix(h, p[i]);
+            }
+            row_tiles[tx] = h;
+        }
+    }
+
+    uint64_t hash = mix(kFnvOffset, (static_cast<uint64_t>(image.cols) << 32) | static_cast<uint32_t>(image.rows));
+    for (uint64_t tile : result->tiles) {
+        hash = mix(hash, tile);
+    }
+    result->hash = hash;
+
+    return result;
+}
+
+bool FrameFingerprint::same_as(const FrameFingerprint& other) const
+{
+    return size == other.size && hash == other.hash && tiles == other.tiles;
+}
+
+bool FrameFingerprint::same_in(const FrameFingerprint& other, const cv::Rect& rect) const
+{
+    if (size != other.size) {
+        return false;
+    }
+
+    cv::Rect clipped = rect & cv::Rect(cv::Point(0, 0), size);
+    if (clipped.empty()) {
+        return true;
+    }
+
+    const int tx_begin = clipped.x / kTileSize;
+    const int tx_end = (clipped.x + clipped.width - 1) / kTileSize;
+    const int ty_begin = clipped.y / kTileSize;
+    const int ty_end = (clipped.y + clipped.height - 1) / kTileSize;
+
+    for (int ty = ty_begin; ty <= ty_end; ++ty) {
+        const size_t row = static_cast<size_t>(ty) * grid.width;
+        for (int tx = tx_begin; tx <= tx_end; ++tx) {
+            if (tiles[row + tx] != other.tiles[row + tx]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+MAA_CTRL_NS_END
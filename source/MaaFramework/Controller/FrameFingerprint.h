@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Common/Conf.h"
+#include "MaaUtils/NoWarningCVMat.hpp"
+
+MAA_CTRL_NS_BEGIN
+
+// 截图的指纹：把图切成固定大小的 tile，每个 tile 算一个哈希
+// 用来判断两帧是否完全相同，代价远小于重新识别
+struct FrameFingerprint
+{
+    static constexpr int kTileSize = 32;
+
+    cv::Size size;
+    cv::Size grid; // tile 的列数和行数，边缘不满 kTileSize 的也算一个
+    std::vector<uint64_t> tiles;
+    uint64_t hash = 0;
+
+    static std::shared_ptr<const FrameFingerprint> make(const cv::Mat& image);
+
+    bool same_as(const FrameFingerprint& other) const;
+    // rect 覆盖到的 tile 在两帧里都没变
+    bool same_in(const FrameFingerprint& other, const cv::Rect& rect) const;
+};
+
+MAA_CTRL_NS_END
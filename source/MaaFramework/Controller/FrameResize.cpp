@@ -0,0 +1,76 @@
+#include "FrameResize.h"
+
+#include <vector>
+
+#include "MaaUtils/NoWarningCV.hpp"
+
+MAA_CTRL_NS_BEGIN
+
+namespace
+{
+bool is_three_to_two(const cv::Size& src, const cv::Size& dst)
+{
+    return src.width % 3 == 0 && src.height % 3 == 0 && dst.width * 3 == src.width * 2 && dst.height * 3 == src.height * 2;
+}
+
+// 每 3x3 个输入像素对应 2x2 个输出像素，面积权重在每个方向上是 (2, 1) 和 (1, 2)，总权重 9
+void resize_area_three_to_two(const cv::Mat& src, cv::Mat& dst)
+{
+    const int cn = src.channels();
+    const int src_row_len = src.cols * cn;
+    const int groups = src.cols / 3;
+
+    cv::parallel_for_(cv::Range(0, dst.rows / 2), [&](const cv::Range& range) {
+        std::vector<uint16_t> v0(src_row_len);
+        std::vector<uint16_t> v1(src_row_len);
+
+        for (int k = range.start; k < range.end; ++k) {
+            const uchar* r0 = src.ptr<uchar>(k * 3);
+            const uchar* r1 = src.ptr<uchar>(k * 3 + 1);
+            const uchar* r2 = src.ptr<uchar>(k * 3 + 2);
+
+            // 先纵向合成两行，这个循环编译器可以直接向量化
+            for (int i = 0; i < src_row_len; ++i) {
+                v0[i] = static_cast<uint16_t>(r0[i] * 2 + r1[i]);
+                v1[i] = static_cast<uint16_t>(r1[i] + r2[i] * 2);
+            }
+
+            uchar* d0 = dst.ptr<uchar>(k * 2);
+            uchar* d1 = dst.ptr<uchar>(k * 2 + 1);
+
+            for (int g = 0; g < groups; ++g) {
+                const int s = g * 3 * cn;
+                const int d = g * 2 * cn;
+                for (int c = 0; c < cn; ++c) {
+                    const int a = s + c;
+                    const int b = a + cn;
+                    const int e = b + cn;
+                    d0[d + c] = static_cast<uchar>((v0[a] * 2 + v0[b] + 4) / 9);
+                    d0[d + cn + c] = static_cast<uchar>((v0[b] + v0[e] * 2 + 4) / 9);
+                    d1[d + c] = static_cast<uchar>((v1[a] * 2 + v1[b] + 4) / 9);
+                    d1[d + cn + c] = static_cast<uchar>((v1[b] + v1[e] * 2 + 4) / 9);
+                }
+            }
+        }
+    });
+}
+} // namespace
+
+void resize_area(const cv::Mat& src, cv::Mat& dst, const cv::Size& size)
+{
+    if (src.size() == size) {
+        src.copyTo(dst);
+        return;
+    }
+
+    if (src.depth() == CV_8U && is_three_to_two(src.size(), size)) {
+        dst.create(size, src.type());
+        resize_area_three_to_two(src, dst);
+        return;
+    }
+
+    // 整数倍缩小（如 2:1）OpenCV 自己有 SIMD 的快速路径
+    cv::resize(src, dst, size, 0, 0, cv::INTER_AREA);
+}
+
+MAA_CTRL_NS_END
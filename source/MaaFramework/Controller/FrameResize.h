@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Common/Conf.h"
+#include "MaaUtils/NoWarningCVMat.hpp"
+
+MAA_CTRL_NS_BEGIN
+
+// 等价于 cv::resize(src, dst, size, 0, 0, cv::INTER_AREA)
+// dst 尺寸类型匹配时直接写进 dst 已有的内存。最常见的 1.5 倍缩小（如 1080p -> 720p）走专门的整数实现
+void resize_area(const cv::Mat& src, cv::Mat& dst, const cv::Size& size);
+
+MAA_CTRL_NS_END
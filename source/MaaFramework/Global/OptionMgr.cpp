@@ -24,6 +24,8 @@ bool OptionMgr::set_option(MaaGlobalOption key, MaaOptionValue value, MaaOptionV
         return set_draw_quality(value, val_size);
     case MaaGlobalOption_RecoImageCacheLimit:
         return set_reco_image_cache_limit(value, val_size);
+    case MaaGlobalOption_ParallelNextList:
+        return set_parallel_next_list(value, val_size);
     default:
         LogError << "Unknown key" << VAR(key) << VAR(value);
         return false;
@@ -148,4 +150,20 @@ bool OptionMgr::set_reco_image_cache_limit(MaaOptionValue value, MaaOptionValueS
     return true;
 }
 
+bool OptionMgr::set_parallel_next_list(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogFunc;
+
+    if (val_size != sizeof(bool)) {
+        LogError << "Invalid value size" << VAR(val_size);
+        return false;
+    }
+
+    parallel_next_list_ = *reinterpret_cast<const bool*>(value);
+
+    LogInfo << "Set parallel next list" << VAR(parallel_next_list_);
+
+    return true;
+}
+
 MAA_GLOBAL_NS_END
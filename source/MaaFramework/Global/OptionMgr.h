@@ -32,6 +32,8 @@ public:
 
     size_t reco_image_cache_limit() const { return reco_image_cache_limit_; }
 
+    bool parallel_next_list() const { return parallel_next_list_; }
+
 private:
     OptionMgr() = default;
 
@@ -43,6 +45,7 @@ private:
     bool set_save_on_error(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_draw_quality(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_reco_image_cache_limit(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_parallel_next_list(MaaOptionValue value, MaaOptionValueSize val_size);
 
 private:
     std::filesystem::path log_dir_;
@@ -51,6 +54,7 @@ private:
     bool save_on_error_ = false;
     int draw_quality_ = 85;
     size_t reco_image_cache_limit_ = 4096;
+    bool parallel_next_list_ = false;
 };
 
 MAA_GLOBAL_NS_END
@@ -1,5 +1,6 @@
 #include "OCRResMgr.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <ranges>
 
@@ -57,6 +58,18 @@ void OCRResMgr::use_coreml(uint32_t coreml_flag)
     use_cpu();
 }
 
+void OCRResMgr::set_pool_size(size_t size)
+{
+    LogInfo << VAR(size);
+
+    std::unique_lock lock(pools_mutex_);
+
+    pool_size_ = std::max<size_t>(size, 1);
+    for (const auto& [name, session_pool] : pools_) {
+        session_pool->set_capacity(pool_size_);
+    }
+}
+
 bool OCRResMgr::lazy_load(const std::filesystem::path& path)
 {
     LogFunc << VAR(path);
@@ -95,51 +108,47 @@ void OCRResMgr::clear()
     LogFunc;
 
     roots_.clear();
-    deters_.clear();
-    recers_.clear();
-    ocrers_.clear();
+
+    std::unique_lock lock(pools_mutex_);
+    pools_.clear();
 }
 
-std::shared_ptr<fastdeploy::vision::ocr::DBDetector> OCRResMgr::deter(const std::string& name)
+OCRSessionPool::Lease OCRResMgr::acquire(const std::string& name)
 {
-    if (auto iter = deters_.find(name); iter != deters_.end()) {
-        return iter->second;
+    auto session_pool = pool(name);
+    if (!session_pool) {
+        return { };
     }
-
-    auto deter = load_deter(name);
-    if (deter) {
-        deters_.emplace(name, deter);
-    }
-
-    return deter;
+    return session_pool->acquire();
 }
 
-std::shared_ptr<fastdeploy::vision::ocr::Recognizer> OCRResMgr::recer(const std::string& name)
+std::unordered_map<std::string, OCRSessionPoolStats> OCRResMgr::pool_stats() const
 {
-    if (auto iter = recers_.find(name); iter != recers_.end()) {
-        return iter->second;
-    }
+    std::unique_lock lock(pools_mutex_);
 
-    auto recer = load_recer(name);
-    if (recer) {
-        recers_.emplace(name, recer);
+    std::unordered_map<std::string, OCRSessionPoolStats> result;
+    for (const auto& [name, session_pool] : pools_) {
+        result.emplace(name, session_pool->stats());
     }
-
-    return recer;
+    return result;
 }
 
-std::shared_ptr<fastdeploy::pipeline::PPOCRv4> OCRResMgr::ocrer(const std::string& name)
+std::shared_ptr<OCRSessionPool> OCRResMgr::pool(const std::string& name)
 {
-    if (auto iter = ocrers_.find(name); iter != ocrers_.end()) {
+    std::unique_lock lock(pools_mutex_);
+
+    if (auto iter = pools_.find(name); iter != pools_.end()) {
         return iter->second;
     }
 
-    auto ocrer = load_ocrer(name);
-    if (ocrer) {
-        ocrers_.emplace(name, ocrer);
+    auto session = load_session(name);
+    if (!session) {
+        return nullptr;
     }
 
-    return ocrer;
+    auto session_pool = std::make_shared<OCRSessionPool>(std::move(session), pool_size_);
+    pools_.emplace(name, session_pool);
+    return session_pool;
 }
 
 std::shared_ptr<fastdeploy::vision::ocr::DBDetector> OCRResMgr::load_deter(const std::string& name)
@@ -202,26 +211,31 @@ std::shared_ptr<fastdeploy::vision::ocr::Recognizer> OCRResMgr::load_recer(const
     return nullptr;
 }
 
-std::shared_ptr<fastdeploy::pipeline::PPOCRv4> OCRResMgr::load_ocrer(const std::string& name)
+std::shared_ptr<OCRSession> OCRResMgr::load_session(const std::string& name)
 {
-    using namespace path_literals;
-
     LogFunc << VAR(name) << VAR(roots_);
 
-    auto det = deter(name);
-    auto rec = recer(name);
-    if (!det || !rec) {
-        LogError << "Failed to load det or rec:" << VAR(name) << VAR(det) << VAR(rec);
+    // 只有 rec 模型的情况下仍然可以用 only_rec
+    auto session = std::make_shared<OCRSession>();
+    session->recer = load_recer(name);
+    if (!session->recer) {
+        LogError << "Failed to load rec:" << VAR(name);
         return nullptr;
     }
 
-    auto ocr = std::make_shared<fastdeploy::pipeline::PPOCRv4>(det.get(), rec.get());
+    session->deter = load_deter(name);
+    if (!session->deter) {
+        LogWarn << "Failed to load det, only_rec available:" << VAR(name);
+        return session;
+    }
 
-    if (!ocr || !ocr->Initialized()) {
-        LogError << "Failed to load PPOCRv4:" << VAR(name) << VAR(ocr) << VAR(ocr->Initialized());
-        return nullptr;
+    session->ocrer = std::make_shared<fastdeploy::pipeline::PPOCRv4>(session->deter.get(), session->recer.get());
+    if (!session->ocrer || !session->ocrer->Initialized()) {
+        LogError << "Failed to load PPOCRv4:" << VAR(name) << VAR(session->ocrer);
+        session->ocrer = nullptr;
     }
-    return ocr;
+
+    return session;
 }
 
 MAA_RES_NS_END
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <mutex>
 
 #include "Common/Conf.h"
 
@@ -16,6 +17,7 @@ MAA_SUPPRESS_CV_WARNINGS_END
 
 #include "MaaUtils/NoWarningCV.hpp"
 #include "MaaUtils/NonCopyable.hpp"
+#include "OCRSessionPool.h"
 
 MAA_RES_NS_BEGIN
 
@@ -29,31 +31,36 @@ public:
     void use_directml(int device_id);
     void use_coreml(uint32_t coreml_flag);
 
+    void set_pool_size(size_t size);
+
     bool lazy_load(const std::filesystem::path& path);
     void clear();
 
 public:
-    std::shared_ptr<fastdeploy::vision::ocr::DBDetector> deter(const std::string& name);
-    std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer(const std::string& name);
-    std::shared_ptr<fastdeploy::pipeline::PPOCRv4> ocrer(const std::string& name);
+    // 借出一组模型实例，Lease 析构前由调用方独占
+    OCRSessionPool::Lease acquire(const std::string& name);
+    std::unordered_map<std::string, OCRSessionPoolStats> pool_stats() const;
 
 private:
     inline static const std::filesystem::path kDetModelFilename = "det.onnx";
     inline static const std::filesystem::path kRecModelFilename = "rec.onnx";
     inline static const std::filesystem::path kKeysFilename = "keys.txt";
+    inline static constexpr size_t kDefaultPoolSize = 2;
 
     std::shared_ptr<fastdeploy::vision::ocr::DBDetector> load_deter(const std::string& name);
     std::shared_ptr<fastdeploy::vision::ocr::Recognizer> load_recer(const std::string& name);
-    std::shared_ptr<fastdeploy::pipeline::PPOCRv4> load_ocrer(const std::string& name);
+    std::shared_ptr<OCRSession> load_session(const std::string& name);
+    std::shared_ptr<OCRSessionPool> pool(const std::string& name);
 
     std::vector<std::filesystem::path> roots_;
 
     fastdeploy::RuntimeOption det_option_;
     fastdeploy::RuntimeOption rec_option_;
 
-    std::unordered_map<std::string, std::shared_ptr<fastdeploy::vision::ocr::DBDetector>> deters_;
-    std::unordered_map<std::string, std::shared_ptr<fastdeploy::vision::ocr::Recognizer>> recers_;
-    std::unordered_map<std::string, std::shared_ptr<fastdeploy::pipeline::PPOCRv4>> ocrers_;
+    size_t pool_size_ = kDefaultPoolSize;
+
+    mutable std::mutex pools_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<OCRSessionPool>> pools_;
 };
 
 MAA_RES_NS_END
@@ -0,0 +1,185 @@
+#include "OCRSessionPool.h"
+
+#include <algorithm>
+
+#include "MaaUtils/Logger.h"
+
+MAA_RES_NS_BEGIN
+
+OCRSessionPool::Lease::Lease(std::shared_ptr<OCRSessionPool> pool, std::shared_ptr<OCRSession> session)
+    : pool_(std::move(pool))
+    , session_(std::move(session))
+{
+}
+
+OCRSessionPool::Lease::~Lease()
+{
+    release();
+}
+
+OCRSessionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::move(other.pool_))
+    , session_(std::move(other.session_))
+{
+}
+
+OCRSessionPool::Lease& OCRSessionPool::Lease::operator=(Lease&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        pool_ = std::move(other.pool_);
+        session_ = std::move(other.session_);
+    }
+    return *this;
+}
+
+void OCRSessionPool::Lease::release()
+{
+    if (pool_ && session_) {
+        pool_->give_back(std::move(session_));
+    }
+    pool_ = nullptr;
+    session_ = nullptr;
+}
+
+OCRSessionPool::OCRSessionPool(std::shared_ptr<OCRSession> prototype, size_t capacity)
+    : prototype_(std::move(prototype))
+    , capacity_(std::max<size_t>(capacity, 1))
+{
+    if (prototype_) {
+        idle_.emplace_back(prototype_);
+        created_ = 1;
+    }
+}
+
+OCRSessionPool::~OCRSessionPool()
+{
+    LogInfo << "ocr session pool stats" << VAR(capacity_) << VAR(created_) << VAR(acquired_) << VAR(waited_) << VAR(total_wait_)
+            << VAR(max_wait_);
+}
+
+OCRSessionPool::Lease OCRSessionPool::acquire()
+{
+    if (!prototype_) {
+        return { };
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    bool need_wait = false;
+
+    std::unique_lock lock(mutex_);
+
+    while (idle_.empty()) {
+        if (created_ < capacity_) {
+            // 先占坑再解锁 clone，避免别的线程同时超额创建
+            ++created_;
+            lock.unlock();
+            auto session = clone_session();
+            lock.lock();
+
+            if (session) {
+                ++acquired_;
+                return Lease(shared_from_this(), std::move(session));
+            }
+
+            --created_;
+            // clone 失败就不再扩容，老老实实等别人归还
+            capacity_ = std::max<size_t>(created_, 1);
+            continue;
+        }
+
+        need_wait = true;
+        cond_.wait(lock, [&]() { return !idle_.empty() || created_ < capacity_; });
+    }
+
+    auto session = std::move(idle_.back());
+    idle_.pop_back();
+    ++acquired_;
+
+    if (need_wait) {
+        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+        ++waited_;
+        total_wait_ += wait;
+        max_wait_ = std::max(max_wait_, wait);
+        LogDebug << "waited for ocr session" << VAR(wait) << VAR(capacity_) << VAR(waited_) << VAR(acquired_);
+    }
+
+    return Lease(shared_from_this(), std::move(session));
+}
+
+void OCRSessionPool::set_capacity(size_t capacity)
+{
+    {
+        std::unique_lock lock(mutex_);
+        capacity_ = std::max<size_t>(capacity, 1);
+        while (created_ > capacity_ && !idle_.empty()) {
+            idle_.pop_back();
+            --created_;
+        }
+    }
+    cond_.notify_all();
+}
+
+OCRSessionPoolStats OCRSessionPool::stats() const
+{
+    std::unique_lock lock(mutex_);
+    return OCRSessionPoolStats {
+        .capacity = capacity_,
+        .created = created_,
+        .idle = idle_.size(),
+        .acquired = acquired_,
+        .waited = waited_,
+        .total_wait_us = total_wait_.count(),
+        .max_wait_us = max_wait_.count(),
+    };
+}
+
+void OCRSessionPool::give_back(std::shared_ptr<OCRSession> session)
+{
+    {
+        std::unique_lock lock(mutex_);
+        if (created_ > capacity_) {
+            // 容量被调小了，多出来的直接释放
+            --created_;
+        }
+        else {
+            idle_.emplace_back(std::move(session));
+        }
+    }
+    cond_.notify_one();
+}
+
+std::shared_ptr<OCRSession> OCRSessionPool::clone_session() const
+{
+    LogFunc;
+
+    auto session = std::make_shared<OCRSession>();
+
+    if (prototype_->deter) {
+        session->deter = prototype_->deter->Clone();
+        if (!session->deter || !session->deter->Initialized()) {
+            LogError << "Failed to clone DBDetector";
+            return nullptr;
+        }
+    }
+
+    if (prototype_->recer) {
+        session->recer = prototype_->recer->Clone();
+        if (!session->recer || !session->recer->Initialized()) {
+            LogError << "Failed to clone Recognizer";
+            return nullptr;
+        }
+    }
+
+    if (session->deter && session->recer) {
+        session->ocrer = std::make_shared<fastdeploy::pipeline::PPOCRv4>(session->deter.get(), session->recer.get());
+        if (!session->ocrer || !session->ocrer->Initialized()) {
+            LogError << "Failed to create PPOCRv4";
+            return nullptr;
+        }
+    }
+
+    return session;
+}
+
+MAA_RES_NS_END
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <meojson/json.hpp>
+
+#include "Common/Conf.h"
+
+MAA_SUPPRESS_CV_WARNINGS_BEGIN
+#include "fastdeploy/vision/ocr/ppocr/dbdetector.h"
+#include "fastdeploy/vision/ocr/ppocr/ppocr_v4.h"
+#include "fastdeploy/vision/ocr/ppocr/recognizer.h"
+MAA_SUPPRESS_CV_WARNINGS_END
+
+#include "MaaUtils/NonCopyable.hpp"
+
+MAA_RES_NS_BEGIN
+
+// 一组可独立推理的模型实例。ocrer 内部引用的是同一组的 deter/recer 裸指针，三者必须同生共死
+struct OCRSession
+{
+    std::shared_ptr<fastdeploy::vision::ocr::DBDetector> deter = nullptr;
+    std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer = nullptr;
+    std::shared_ptr<fastdeploy::pipeline::PPOCRv4> ocrer = nullptr;
+};
+
+struct OCRSessionPoolStats
+{
+    size_t capacity = 0;
+    size_t created = 0;
+    size_t idle = 0;
+    uint64_t acquired = 0;
+    uint64_t waited = 0;
+    int64_t total_wait_us = 0;
+    int64_t max_wait_us = 0;
+
+    MEO_JSONIZATION(capacity, created, idle, acquired, waited, total_wait_us, max_wait_us);
+};
+
+class OCRSessionPool
+    : public NonCopyable
+    , public std::enable_shared_from_this<OCRSessionPool>
+{
+public:
+    // 借出的 session，析构时自动归还
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(std::shared_ptr<OCRSessionPool> pool, std::shared_ptr<OCRSession> session);
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+
+        explicit operator bool() const { return session_ != nullptr; }
+
+        const OCRSession* operator->() const { return session_.get(); }
+
+    private:
+        void release();
+
+        std::shared_ptr<OCRSessionPool> pool_ = nullptr;
+        std::shared_ptr<OCRSession> session_ = nullptr;
+    };
+
+public:
+    OCRSessionPool(std::shared_ptr<OCRSession> prototype, size_t capacity);
+    ~OCRSessionPool();
+
+    Lease acquire();
+    void set_capacity(size_t capacity);
+    OCRSessionPoolStats stats() const;
+
+private:
+    void give_back(std::shared_ptr<OCRSession> session);
+    std::shared_ptr<OCRSession> clone_session() const;
+
+    const std::shared_ptr<OCRSession> prototype_ = nullptr;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+
+    std::vector<std::shared_ptr<OCRSession>> idle_;
+    size_t capacity_ = 1;
+    size_t created_ = 0;
+
+    // 通过 MaaResourceGetOCRSessionPoolStats 查询，据此调整 MaaResOption_OCRSessionPoolSize
+    uint64_t acquired_ = 0;
+    uint64_t waited_ = 0;
+    std::chrono::microseconds total_wait_ { 0 };
+    std::chrono::microseconds max_wait_ { 0 };
+};
+
+MAA_RES_NS_END
@@ -135,12 +135,16 @@ void ONNXResMgr::clear()
 
     classifier_roots_.clear();
     detector_roots_.clear();
+
+    std::unique_lock lock(sessions_mutex_);
     classifiers_.clear();
     detectors_.clear();
 }
 
-std::shared_ptr<Ort::Session> ONNXResMgr::classifier(const std::string& name)
+MAA_VISION_NS::ONNXSessionPtr ONNXResMgr::classifier(const std::string& name)
 {
+    std::unique_lock lock(sessions_mutex_);
+
     if (auto iter = classifiers_.find(name); iter != classifiers_.end()) {
         return iter->second;
     }
@@ -153,8 +157,10 @@ std::shared_ptr<Ort::Session> ONNXResMgr::classifier(const std::string& name)
     return session;
 }
 
-std::shared_ptr<Ort::Session> ONNXResMgr::detector(const std::string& name)
+MAA_VISION_NS::ONNXSessionPtr ONNXResMgr::detector(const std::string& name)
 {
+    std::unique_lock lock(sessions_mutex_);
+
     if (auto iter = detectors_.find(name); iter != detectors_.end()) {
         return iter->second;
     }
@@ -172,7 +178,7 @@ const Ort::MemoryInfo& ONNXResMgr::memory_info() const
     return memory_info_;
 }
 
-std::shared_ptr<Ort::Session> ONNXResMgr::load(const std::string& name, const std::vector<std::filesystem::path>& roots)
+MAA_VISION_NS::ONNXSessionPtr ONNXResMgr::load(const std::string& name, const std::vector<std::filesystem::path>& roots)
 {
     LogFunc << VAR(name) << VAR(roots);
 
@@ -184,7 +190,7 @@ std::shared_ptr<Ort::Session> ONNXResMgr::load(const std::string& name, const st
 
         LogDebug << VAR(path);
         Ort::Session session(env_, path.c_str(), options_);
-        return std::make_shared<Ort::Session>(std::move(session));
+        return MAA_VISION_NS::make_onnx_session(std::move(session));
     }
 
     return nullptr;
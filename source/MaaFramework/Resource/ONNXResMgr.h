@@ -2,12 +2,14 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include <onnxruntime/onnxruntime_cxx_api.h>
 
 #include "Common/Conf.h"
 #include "MaaUtils/NonCopyable.hpp"
+#include "Vision/ONNXSession.hpp"
 
 MAA_RES_NS_BEGIN
 
@@ -27,12 +29,12 @@ public:
     void clear();
 
 public:
-    std::shared_ptr<Ort::Session> classifier(const std::string& name);
-    std::shared_ptr<Ort::Session> detector(const std::string& name);
+    MAA_VISION_NS::ONNXSessionPtr classifier(const std::string& name);
+    MAA_VISION_NS::ONNXSessionPtr detector(const std::string& name);
     const Ort::MemoryInfo& memory_info() const;
 
 private:
-    std::shared_ptr<Ort::Session> load(const std::string& name, const std::vector<std::filesystem::path>& roots);
+    MAA_VISION_NS::ONNXSessionPtr load(const std::string& name, const std::vector<std::filesystem::path>& roots);
 
     std::vector<std::filesystem::path> classifier_roots_;
     std::vector<std::filesystem::path> detector_roots_;
@@ -41,8 +43,9 @@ private:
     Ort::SessionOptions options_;
     Ort::MemoryInfo memory_info_;
 
-    std::unordered_map<std::string, std::shared_ptr<Ort::Session>> classifiers_;
-    std::unordered_map<std::string, std::shared_ptr<Ort::Session>> detectors_;
+    std::mutex sessions_mutex_;
+    std::unordered_map<std::string, MAA_VISION_NS::ONNXSessionPtr> classifiers_;
+    std::unordered_map<std::string, MAA_VISION_NS::ONNXSessionPtr> detectors_;
 };
 
 MAA_RES_NS_END
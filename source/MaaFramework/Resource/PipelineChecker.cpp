@@ -17,15 +17,41 @@ bool PipelineChecker::check_all_validity(const PipelineDataMap& data_map)
     return ret;
 }
 
+bool PipelineChecker::check_nodes_validity(const std::vector<std::string>& names, const PipelineGraph& graph)
+{
+    for (const auto& name : names) {
+        auto id = graph.find(name);
+        if (id == PipelineGraph::kInvalidId) {
+            LogError << "node not found" << VAR(name);
+            return false;
+        }
+        const auto& pipeline_data = graph.at(id);
+
+        if (!check_next_list(pipeline_data->next, graph)) {
+            LogError << "check_next_list next failed" << VAR(name) << VAR(pipeline_data->next);
+            return false;
+        }
+        if (!check_next_list(pipeline_data->on_error, graph)) {
+            LogError << "check_next_list on_error failed" << VAR(name) << VAR(pipeline_data->on_error);
+            return false;
+        }
+        if (!check_regex(*pipeline_data)) {
+            LogError << "regex invalid" << VAR(name);
+            return false;
+        }
+    }
+    return true;
+}
+
 bool PipelineChecker::check_all_next_list(const PipelineDataMap& data_map)
 {
     for (const auto& [name, pipeline_data] : data_map) {
-        if (!check_next_list(pipeline_data.next, data_map)) {
-            LogError << "check_next_list next failed" << VAR(name) << VAR(pipeline_data.next);
+        if (!check_next_list(pipeline_data->next, data_map)) {
+            LogError << "check_next_list next failed" << VAR(name) << VAR(pipeline_data->next);
             return false;
         }
-        if (!check_next_list(pipeline_data.on_error, data_map)) {
-            LogError << "check_next_list on_error failed" << VAR(name) << VAR(pipeline_data.on_error);
+        if (!check_next_list(pipeline_data->on_error, data_map)) {
+            LogError << "check_next_list on_error failed" << VAR(name) << VAR(pipeline_data->on_error);
             return false;
         }
     }
@@ -34,32 +60,50 @@ bool PipelineChecker::check_all_next_list(const PipelineDataMap& data_map)
 
 bool PipelineChecker::check_all_regex(const PipelineDataMap& data_map)
 {
+    for (const auto& [name, pipeline_data] : data_map) {
+        if (!check_regex(*pipeline_data)) {
+            LogError << "regex invalid" << VAR(name);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PipelineChecker::check_regex(const PipelineData& pipeline_data)
+{
+    if (pipeline_data.reco_type != Recognition::Type::OCR) {
+        return true;
+    }
+
     auto is_valid = [](const std::wstring& regex) {
         return regex_valid(regex).has_value();
     };
 
-    for (const auto& [name, pipeline_data] : data_map) {
-        if (pipeline_data.reco_type != Recognition::Type::OCR) {
+    const auto& reco_param = std::get<MAA_VISION_NS::OCRerParam>(pipeline_data.reco_param);
+    return std::ranges::all_of(reco_param.expected, is_valid) && std::ranges::all_of(reco_param.replace | std::views::keys, is_valid);
+}
+
+bool PipelineChecker::check_next_list(const std::vector<NodeAttr>& next_list, const PipelineDataMap& data_map)
+{
+    for (const auto& node : next_list) {
+        if (node.anchor) {
             continue;
         }
-        const auto& reco_param = std::get<MAA_VISION_NS::OCRerParam>(pipeline_data.reco_param);
-        bool valid =
-            std::ranges::all_of(reco_param.expected, is_valid) && std::ranges::all_of(reco_param.replace | std::views::keys, is_valid);
-        if (!valid) {
-            LogError << "regex invalid" << VAR(name);
+        if (!data_map.contains(node.name)) {
+            LogError << "Invalid next node name" << VAR(node.name);
             return false;
         }
     }
     return true;
 }
 
-bool PipelineChecker::check_next_list(const std::vector<NodeAttr>& next_list, const PipelineDataMap& data_map)
+bool PipelineChecker::check_next_list(const std::vector<NodeAttr>& next_list, const PipelineGraph& graph)
 {
     for (const auto& node : next_list) {
         if (node.anchor) {
             continue;
         }
-        if (!data_map.contains(node.name)) {
+        if (graph.find(node.name) == PipelineGraph::kInvalidId) {
             LogError << "Invalid next node name" << VAR(node.name);
             return false;
         }
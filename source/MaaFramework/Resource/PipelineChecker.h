@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common/Conf.h"
+#include "PipelineGraph.h"
 #include "PipelineTypes.h"
 
 MAA_RES_NS_BEGIN
@@ -11,12 +12,17 @@ public:
     PipelineChecker() = delete;
 
     static bool check_all_validity(const PipelineDataMap& data_map);
+    // 只检查 names 中的节点（一般是刚 override 的），其余节点视为已经检查过
+    static bool check_nodes_validity(const std::vector<std::string>& names, const PipelineGraph& graph);
+    // OCR 的 expected / replace 等正则是否合法
+    static bool check_regex(const PipelineData& pipeline_data);
 
 private:
     static bool check_all_next_list(const PipelineDataMap& data_map);
     static bool check_all_regex(const PipelineDataMap& data_map);
 
     static bool check_next_list(const std::vector<NodeAttr>& next_list, const PipelineDataMap& data_map);
+    static bool check_next_list(const std::vector<NodeAttr>& next_list, const PipelineGraph& graph);
 };
 
 MAA_RES_NS_END
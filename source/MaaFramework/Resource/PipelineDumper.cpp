@@ -107,6 +107,7 @@ PipelineV2::JRecognition PipelineDumper::dump_reco(Recognition::Type type, const
             .index = p.result_index,
             .method = p.method,
             .green_mask = p.green_mask,
+            .pyramid = p.pyramid,
         };
     } break;
 
@@ -0,0 +1,112 @@
+#include "PipelineGraph.h"
+
+#include "MaaUtils/Logger.h"
+
+MAA_RES_NS_BEGIN
+
+std::shared_ptr<const PipelineGraph> PipelineGraph::compile(const PipelineDataMap& data_map, std::shared_ptr<const PipelineGraph> base)
+{
+    auto graph = std::make_shared<PipelineGraph>();
+
+    graph->base_ = std::move(base);
+    graph->id_offset_ = graph->base_ ? static_cast<NodeId>(graph->base_->size()) : 0;
+
+    graph->ids_.reserve(data_map.size());
+    graph->nodes_.reserve(data_map.size());
+
+    for (const auto& [name, data] : data_map) {
+        const auto local = static_cast<uint32_t>(graph->nodes_.size());
+        graph->nodes_.emplace_back(data);
+
+        NodeId base_id = graph->base_ ? graph->base_->find(name) : kInvalidId;
+        if (base_id != kInvalidId) {
+            graph->replaced_.emplace(base_id, local);
+            graph->ids_.emplace(name, base_id);
+        }
+        else {
+            graph->ids_.emplace(name, graph->id_offset_ + local);
+        }
+    }
+
+    // 底图节点的边不会指向本层新增的节点（底图自己已经检查过），只需解析本层节点的边
+    auto add_edges = [&](const std::vector<NodeAttr>& list) {
+        for (const auto& attr : list) {
+            graph->edges_.emplace_back(attr.anchor ? kInvalidId : graph->find(attr.name));
+        }
+        return static_cast<uint32_t>(graph->edges_.size());
+    };
+
+    graph->spans_.resize(graph->nodes_.size());
+    for (size_t local = 0; local < graph->nodes_.size(); ++local) {
+        const auto& data = graph->nodes_[local];
+        auto& spans = graph->spans_[local];
+
+        spans.next_begin = static_cast<uint32_t>(graph->edges_.size());
+        spans.next_end = add_edges(data->next);
+        spans.on_error_begin = spans.next_end;
+        spans.on_error_end = add_edges(data->on_error);
+    }
+
+    LogDebug << "pipeline graph compiled" << VAR(graph->nodes_.size()) << VAR(graph->edges_.size()) << VAR(graph->id_offset_);
+    return graph;
+}
+
+PipelineGraph::NodeId PipelineGraph::find(const std::string& name) const
+{
+    if (auto it = ids_.find(name); it != ids_.end()) {
+        return it->second;
+    }
+    return base_ ? base_->find(name) : kInvalidId;
+}
+
+const PipelineDataPtr& PipelineGraph::at(NodeId id) const
+{
+    if (auto local = local_index(id)) {
+        return nodes_.at(*local);
+    }
+    return base_->at(id);
+}
+
+std::span<const PipelineGraph::NodeId> PipelineGraph::next(NodeId id) const
+{
+    auto local = local_index(id);
+    if (!local) {
+        return base_->next(id);
+    }
+    const auto& spans = spans_.at(*local);
+    return std::span(edges_).subspan(spans.next_begin, spans.next_end - spans.next_begin);
+}
+
+std::span<const PipelineGraph::NodeId> PipelineGraph::on_error(NodeId id) const
+{
+    auto local = local_index(id);
+    if (!local) {
+        return base_->on_error(id);
+    }
+    const auto& spans = spans_.at(*local);
+    return std::span(edges_).subspan(spans.on_error_begin, spans.on_error_end - spans.on_error_begin);
+}
+
+std::vector<PipelineGraph::NodeId> PipelineGraph::resolve(const std::vector<NodeAttr>& list) const
+{
+    std::vector<NodeId> ids;
+    ids.reserve(list.size());
+    for (const auto& attr : list) {
+        ids.emplace_back(attr.anchor ? kInvalidId : find(attr.name));
+    }
+    return ids;
+}
+
+std::optional<uint32_t> PipelineGraph::local_index(NodeId id) const
+{
+    if (id >= id_offset_) {
+        return id - id_offset_;
+    }
+    if (replaced_.empty()) {
+        return std::nullopt;
+    }
+    auto it = replaced_.find(id);
+    return it == replaced_.end() ? std::nullopt : std::make_optional(it->second);
+}
+
+MAA_RES_NS_END
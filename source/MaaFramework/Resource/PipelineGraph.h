@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/Conf.h"
+#include "PipelineTypes.h"
+
+MAA_RES_NS_BEGIN
+
+// 编译后的 pipeline 图：节点名映射成连续的整数 id，节点按 id 存在数组里，
+// 每个节点的 next / on_error 预先解析成 id 列表。只有 [Anchor] 要在运行时按锚点解析
+// 可以叠加在另一张图上：只编译叠加的节点，同名节点沿用底图的 id，新节点的 id 接在底图后面
+class PipelineGraph
+{
+public:
+    using NodeId = uint32_t;
+    inline static constexpr NodeId kInvalidId = std::numeric_limits<NodeId>::max();
+
+    // base 不为空时 data_map 里的节点覆盖 base 里的同名节点，开销只和 data_map 的大小有关
+    static std::shared_ptr<const PipelineGraph>
+        compile(const PipelineDataMap& data_map, std::shared_ptr<const PipelineGraph> base = nullptr);
+
+public:
+    size_t size() const { return id_offset_ + nodes_.size(); }
+
+    NodeId find(const std::string& name) const;
+    const PipelineDataPtr& at(NodeId id) const;
+
+    // 与 PipelineData::next / on_error 一一对应，[Anchor] 和不存在的节点为 kInvalidId
+    std::span<const NodeId> next(NodeId id) const;
+    std::span<const NodeId> on_error(NodeId id) const;
+
+    // 不在图里的列表（如任务入口）临时解析一次
+    std::vector<NodeId> resolve(const std::vector<NodeAttr>& list) const;
+
+private:
+    // id 对应本层 nodes_ 的下标，不在本层时为 nullopt
+    std::optional<uint32_t> local_index(NodeId id) const;
+
+    struct Spans
+    {
+        uint32_t next_begin = 0;
+        uint32_t next_end = 0;
+        uint32_t on_error_begin = 0;
+        uint32_t on_error_end = 0;
+    };
+
+    std::shared_ptr<const PipelineGraph> base_ = nullptr;
+    NodeId id_offset_ = 0; // 本层新节点 id 的起点，即底图的 size()
+
+    std::unordered_map<std::string, NodeId> ids_;
+    std::unordered_map<NodeId, uint32_t> replaced_; // 被本层覆盖的底图节点 id -> nodes_ 下标
+    std::vector<PipelineDataPtr> nodes_;
+    std::vector<Spans> spans_;
+    std::vector<NodeId> edges_;
+};
+
+using PipelineGraphPtr = std::shared_ptr<const PipelineGraph>;
+
+// 编译过的 next 列表，attrs 用于回调和日志，ids 与之一一对应
+// graph 过期（资源或 context 被 override）时按名字重新解析
+struct CompiledList
+{
+    PipelineGraphPtr graph = nullptr;
+    std::vector<NodeAttr> attrs;
+    std::vector<PipelineGraph::NodeId> ids;
+};
+
+MAA_RES_NS_END
@@ -528,6 +528,15 @@ bool PipelineParser::parse_template_matcher_param(
         return false;
     }
 
+    if (!get_and_check_value(input, "pyramid", output.pyramid, default_value.pyramid)) {
+        LogError << "failed to get_and_check_value pyramid" << VAR(input);
+        return false;
+    }
+    if (output.pyramid < 0 || output.pyramid > MAA_VISION_NS::TemplateMatcherParam::kMaxPyramid) {
+        LogError << "pyramid out of range" << VAR(output.pyramid) << VAR(MAA_VISION_NS::TemplateMatcherParam::kMaxPyramid);
+        return false;
+    }
+
     return true;
 }
 
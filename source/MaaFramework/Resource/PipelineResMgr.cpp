@@ -14,7 +14,10 @@ bool PipelineResMgr::load(const std::filesystem::path& path, const DefaultPipeli
 {
     LogFunc << VAR(path);
 
-    if (!load_all_json(path, default_mgr)) {
+    bool loaded = load_all_json(path, default_mgr);
+    compile_graph();
+
+    if (!loaded) {
         LogError << "load_all_json failed" << VAR(path);
         return false;
     }
@@ -34,7 +37,10 @@ bool PipelineResMgr::load_file(const std::filesystem::path& path, const DefaultP
     LogFunc << VAR(path);
 
     std::set<std::string> existing_keys;
-    if (!open_and_parse_file(path, existing_keys, default_mgr)) {
+    bool parsed = open_and_parse_file(path, existing_keys, default_mgr);
+    compile_graph();
+
+    if (!parsed) {
         LogError << "open_and_parse_file failed" << VAR(path);
         return false;
     }
@@ -55,6 +61,12 @@ void PipelineResMgr::clear()
 
     pipeline_data_map_.clear();
     paths_.clear();
+    compile_graph();
+}
+
+void PipelineResMgr::compile_graph()
+{
+    graph_ = PipelineGraph::compile(pipeline_data_map_);
 }
 
 bool PipelineResMgr::load_all_json(const std::filesystem::path& path, const DefaultPipelineMgr& default_mgr)
@@ -186,7 +198,8 @@ bool PipelineResMgr::parse_and_override_once(
         }
 
         PipelineData result;
-        const auto& default_result = pipeline_data_map_.contains(key) ? pipeline_data_map_.at(key) : default_mgr.get_pipeline();
+        auto it = pipeline_data_map_.find(key);
+        const auto& default_result = it != pipeline_data_map_.end() ? *it->second : default_mgr.get_pipeline();
         bool ret = PipelineParser::parse_node(key, value, result, default_result, default_mgr);
         if (!ret) {
             LogError << "parse_task failed" << VAR(key) << VAR(value);
@@ -194,7 +207,7 @@ bool PipelineResMgr::parse_and_override_once(
         }
 
         existing_keys.emplace(key);
-        pipeline_data_map_.insert_or_assign(key, std::move(result));
+        pipeline_data_map_.insert_or_assign(key, std::make_shared<const PipelineData>(std::move(result)));
     }
 
     return true;
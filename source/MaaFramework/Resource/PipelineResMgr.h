@@ -8,6 +8,7 @@
 
 #include "Common/Conf.h"
 #include "DefaultPipelineMgr.h"
+#include "PipelineGraph.h"
 #include "MaaUtils/NonCopyable.hpp"
 #include "PipelineTypes.h"
 
@@ -29,6 +30,11 @@ public:
 
     PipelineDataMap& get_pipeline_data_map() { return pipeline_data_map_; }
 
+    const PipelineGraphPtr& get_graph() const { return graph_; }
+
+    // 直接改了 pipeline_data_map_ 之后要调用，重新编译 graph_
+    void compile_graph();
+
     std::vector<std::string> get_node_list() const;
 
 public:
@@ -43,6 +49,7 @@ private:
 private:
     std::vector<std::filesystem::path> paths_;
     PipelineDataMap pipeline_data_map_;
+    PipelineGraphPtr graph_ = PipelineGraph::compile({ });
 };
 
 MAA_RES_NS_END
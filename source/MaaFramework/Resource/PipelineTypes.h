@@ -400,6 +400,8 @@ MAA_RES_NS_END
 MAA_NS_BEGIN
 
 using PipelineData = MAA_RES_NS::PipelineData;
-using PipelineDataMap = std::unordered_map<std::string, PipelineData>;
+// 节点解析完就不再修改，各处共享同一份；要改时先拷一份再整体替换
+using PipelineDataPtr = std::shared_ptr<const PipelineData>;
+using PipelineDataMap = std::unordered_map<std::string, PipelineDataPtr>;
 
 MAA_NS_END
@@ -34,8 +34,9 @@ struct JTemplateMatch
     int index = 0;
     int method = 0;
     bool green_mask = false;
+    int pyramid = 0;
 
-    MEO_TOJSON(roi, roi_offset, MEO_KEY("template") template_, threshold, order_by, index, method, green_mask);
+    MEO_TOJSON(roi, roi_offset, MEO_KEY("template") template_, threshold, order_by, index, method, green_mask, pyramid);
 };
 
 struct JFeatureMatch
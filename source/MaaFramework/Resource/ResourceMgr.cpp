@@ -1,5 +1,6 @@
 #include "ResourceMgr.h"
 
+#include <format>
 #include <tuple>
 
 #include "Global/PluginMgr.h"
@@ -8,6 +9,7 @@
 #include "MaaUtils/GpuOption.h"
 #include "MaaUtils/Logger.h"
 #include "MaaUtils/Platform.h"
+#include "PipelineChecker.h"
 #include "PipelineDumper.h"
 #include "PipelineParser.h"
 
@@ -44,6 +46,9 @@ bool ResourceMgr::set_option(MaaResOption key, MaaOptionValue value, MaaOptionVa
     case MaaResOption_InferenceExecutionProvider:
         return set_inference_execution_provider(value, val_size);
 
+    case MaaResOption_OCRSessionPoolSize:
+        return set_ocr_session_pool_size(value, val_size);
+
     default:
         LogError << "Unknown key" << VAR(key) << VAR(value);
         return false;
@@ -131,6 +136,15 @@ std::string ResourceMgr::get_hash() const
     return hash_cache_;
 }
 
+json::object ResourceMgr::get_ocr_session_pool_stats() const
+{
+    json::object result;
+    for (const auto& [name, stats] : ocr_res_.pool_stats()) {
+        result.emplace(name, stats);
+    }
+    return result;
+}
+
 std::vector<std::string> ResourceMgr::get_node_list() const
 {
     return pipeline_res_.get_node_list();
@@ -238,6 +252,7 @@ bool ResourceMgr::clear()
     template_res_.clear();
     paths_.clear();
     hash_cache_.clear();
+    clear_direct_node_cache();
 
     valid_ = true;
 
@@ -249,18 +264,27 @@ bool ResourceMgr::override_pipeline(const json::value& pipeline_override)
     LogInfo << VAR(pipeline_override);
 
     std::set<std::string> existing_keys;
-    return pipeline_res_.parse_and_override(pipeline_override, existing_keys, default_pipeline_);
+    bool ret = pipeline_res_.parse_and_override(pipeline_override, existing_keys, default_pipeline_);
+    pipeline_res_.compile_graph();
+    return ret;
 }
 
 bool ResourceMgr::override_next(const std::string& node_name, const std::vector<std::string>& next)
 {
     LogInfo << VAR(node_name) << VAR(next);
 
-    if (!PipelineParser::parse_next(next, pipeline_res_.get_pipeline_data_map()[node_name].next)) {
+    auto& pp_map = pipeline_res_.get_pipeline_data_map();
+    auto it = pp_map.find(node_name);
+    // 已经拿到旧数据的任务继续用旧的，这里拷一份改完再替换
+    PipelineData data = it != pp_map.end() ? *it->second : PipelineData { };
+
+    if (!PipelineParser::parse_next(next, data.next)) {
         LogError << "failed to parse_next" << VAR(next);
         return false;
     }
 
+    pp_map.insert_or_assign(node_name, std::make_shared<const PipelineData>(std::move(data)));
+    pipeline_res_.compile_graph();
     return true;
 }
 
@@ -280,7 +304,7 @@ std::optional<json::object> ResourceMgr::get_node_data(const std::string& node_n
         return std::nullopt;
     }
 
-    return PipelineDumper::dump(it->second);
+    return PipelineDumper::dump(*it->second);
 }
 
 void ResourceMgr::register_custom_recognition(const std::string& name, MaaCustomRecognitionCallback recognition, void* trans_arg)
@@ -361,6 +385,59 @@ CustomActionSession ResourceMgr::custom_action(const std::string& name) const
     return it->second;
 }
 
+PipelineDataPtr ResourceMgr::get_direct_recognition_node(const std::string& reco_type, const json::value& reco_param) const
+{
+    return get_direct_node("recognition", reco_type, reco_param);
+}
+
+PipelineDataPtr ResourceMgr::get_direct_action_node(const std::string& action_type, const json::value& action_param) const
+{
+    return get_direct_node("action", action_type, action_param);
+}
+
+PipelineDataPtr ResourceMgr::get_direct_node(const std::string& kind, const std::string& type, const json::value& param) const
+{
+    std::string name = std::format("{}/{}", kind, type);
+    std::string key = std::format("{}\n{}", name, param.to_string());
+
+    {
+        std::unique_lock lock(direct_node_mutex_);
+        if (auto it = direct_node_cache_.find(key); it != direct_node_cache_.end()) {
+            return it->second;
+        }
+    }
+
+    json::value input;
+    input[kind] = { { "type", type }, { "param", param } };
+
+    PipelineData data;
+    if (!PipelineParser::parse_node(name, input, data, default_pipeline_.get_pipeline(), default_pipeline_)) {
+        LogError << "failed to parse_node" << VAR(name) << VAR(input);
+        return nullptr;
+    }
+    // 节点不进 pipeline，next 为空，只需检查正则
+    if (!PipelineChecker::check_regex(data)) {
+        LogError << "regex invalid" << VAR(name) << VAR(input);
+        return nullptr;
+    }
+
+    auto node = std::make_shared<const PipelineData>(std::move(data));
+
+    std::unique_lock lock(direct_node_mutex_);
+    if (direct_node_cache_.size() >= kDirectNodeCacheSize) {
+        LogDebug << "direct node cache full, clear" << VAR(direct_node_cache_.size());
+        direct_node_cache_.clear();
+    }
+    direct_node_cache_.insert_or_assign(std::move(key), node);
+    return node;
+}
+
+void ResourceMgr::clear_direct_node_cache()
+{
+    std::unique_lock lock(direct_node_mutex_);
+    direct_node_cache_.clear();
+}
+
 const std::unordered_set<MaaInferenceExecutionProvider>& ResourceMgr::available_providers()
 {
     static std::unordered_set<MaaInferenceExecutionProvider> s_provider_cache;
@@ -433,6 +510,25 @@ bool ResourceMgr::set_inference_execution_provider(MaaOptionValue value, MaaOpti
     return true;
 }
 
+bool ResourceMgr::set_ocr_session_pool_size(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogFunc << VAR_VOIDP(value) << VAR(val_size);
+
+    if (val_size != sizeof(int32_t)) {
+        LogError << "invalid size" << VAR(val_size);
+        return false;
+    }
+
+    int32_t size = *reinterpret_cast<int32_t*>(value);
+    if (size <= 0) {
+        LogError << "invalid pool size" << VAR(size);
+        return false;
+    }
+
+    ocr_res_.set_pool_size(static_cast<size_t>(size));
+    return true;
+}
+
 bool ResourceMgr::check_and_set_inference_device()
 {
     if (inference_device_setted_) {
@@ -656,6 +752,9 @@ bool ResourceMgr::load_bundle(const std::filesystem::path& path)
         to_load = true;
         ret &= default_pipeline_.load(j_path);
     }
+    if (to_load) {
+        clear_direct_node_cache();
+    }
 
     if (auto p = path / "pipeline"_path; std::filesystem::exists(p)) {
         to_load = true;
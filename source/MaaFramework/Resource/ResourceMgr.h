@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>
 
 #include "Base/AsyncRunner.hpp"
 #include "Common/MaaTypes.h"
@@ -82,6 +83,8 @@ public: // MaaResource
     virtual std::optional<json::object> get_default_recognition_param(const std::string& reco_type) const override;
     virtual std::optional<json::object> get_default_action_param(const std::string& action_type) const override;
 
+    virtual json::object get_ocr_session_pool_stats() const override;
+
     virtual MaaSinkId add_sink(MaaEventCallback callback, void* trans_arg) override;
     virtual void remove_sink(MaaSinkId sink_id) override;
     virtual void clear_sinks() override;
@@ -113,11 +116,16 @@ public:
     CustomRecognitionSession custom_recognition(const std::string& name) const;
     CustomActionSession custom_action(const std::string& name) const;
 
+    // run_recognition_direct / post_recognition 等直接调用用的节点，不进 pipeline，按类型和参数缓存解析结果
+    PipelineDataPtr get_direct_recognition_node(const std::string& reco_type, const json::value& reco_param) const;
+    PipelineDataPtr get_direct_action_node(const std::string& action_type, const json::value& action_param) const;
+
 private:
     static const std::unordered_set<MaaInferenceExecutionProvider>& available_providers();
 
     bool set_inference_device(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_inference_execution_provider(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_ocr_session_pool_size(MaaOptionValue value, MaaOptionValueSize val_size);
 
     bool check_and_set_inference_device();
     bool use_auto_ep();
@@ -135,6 +143,9 @@ private:
     bool load_image(const std::filesystem::path& path);
     bool check_stop();
 
+    PipelineDataPtr get_direct_node(const std::string& kind, const std::string& type, const json::value& param) const;
+    void clear_direct_node_cache();
+
 private:
     bool need_to_stop_ = false;
 
@@ -148,6 +159,11 @@ private:
     std::unordered_map<std::string, CustomRecognitionSession> custom_recognition_sessions_;
     std::unordered_map<std::string, CustomActionSession> custom_action_sessions_;
 
+    // key 为节点名加参数的序列化结果，依赖 default_pipeline_，其变化时清空
+    inline static constexpr size_t kDirectNodeCacheSize = 256;
+    mutable std::mutex direct_node_mutex_;
+    mutable std::unordered_map<std::string, PipelineDataPtr> direct_node_cache_;
+
 private:
     std::vector<std::filesystem::path> paths_;
     mutable std::string hash_cache_;
@@ -2,6 +2,7 @@
 
 #include "MaaUtils/ImageIo.h"
 #include "MaaUtils/Logger.h"
+#include "Vision/VisionUtils.hpp"
 
 MAA_RES_NS_BEGIN
 
@@ -29,7 +30,8 @@ bool TemplateResMgr::load_file(const std::filesystem::path& path)
     }
 
     auto name = path_to_utf8_string(path.filename());
-    image_cache_[name] = { std::move(image) };
+    std::unique_lock lock(cache_mutex_);
+    image_cache_[name] = { MAA_VISION_NS::prepare_template(std::move(image)) };
     return true;
 }
 
@@ -38,11 +40,15 @@ void TemplateResMgr::clear()
     LogFunc;
 
     roots_.clear();
+
+    std::unique_lock lock(cache_mutex_);
     image_cache_.clear();
 }
 
-std::vector<cv::Mat> TemplateResMgr::get_image(const std::string& name)
+TemplateResMgr::TemplateList TemplateResMgr::get_image(const std::string& name)
 {
+    std::unique_lock lock(cache_mutex_);
+
     if (auto iter = image_cache_.find(name); iter != image_cache_.end()) {
         return iter->second;
     }
@@ -51,16 +57,17 @@ std::vector<cv::Mat> TemplateResMgr::get_image(const std::string& name)
     if (imgs.empty()) {
         return { };
     }
-    image_cache_.emplace(name, imgs);
-    return imgs;
+    return image_cache_.emplace(name, std::move(imgs)).first->second;
 }
 
 void TemplateResMgr::set_image(const std::string& name, const cv::Mat& image)
 {
-    image_cache_[name] = { image };
+    auto prepared = MAA_VISION_NS::prepare_template(image);
+    std::unique_lock lock(cache_mutex_);
+    image_cache_[name] = prepared ? TemplateList { std::move(prepared) } : TemplateList { };
 }
 
-std::vector<cv::Mat> TemplateResMgr::load(const std::string& name)
+TemplateResMgr::TemplateList TemplateResMgr::load(const std::string& name)
 {
     LogFunc << VAR(name) << VAR(roots_);
 
@@ -80,7 +87,7 @@ std::vector<cv::Mat> TemplateResMgr::load(const std::string& name)
         return image;
     };
 
-    std::vector<cv::Mat> results;
+    TemplateList results;
 
     for (const auto& root : roots_ | std::views::reverse) {
         auto path = root / MAA_NS::path(name);
@@ -94,7 +101,7 @@ std::vector<cv::Mat> TemplateResMgr::load(const std::string& name)
             if (image.empty()) {
                 continue;
             }
-            results.emplace_back(std::move(image));
+            results.emplace_back(MAA_VISION_NS::prepare_template(std::move(image)));
         }
         else if (std::filesystem::is_directory(path)) {
             for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
@@ -105,7 +112,7 @@ std::vector<cv::Mat> TemplateResMgr::load(const std::string& name)
                 if (image.empty()) {
                     continue;
                 }
-                results.emplace_back(std::move(image));
+                results.emplace_back(MAA_VISION_NS::prepare_template(std::move(image)));
             }
         }
         else {
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <filesystem>
+#include <mutex>
 #include <unordered_map>
 
 #include "Common/Conf.h"
 #include "MaaUtils/NoWarningCVMat.hpp"
 #include "MaaUtils/NonCopyable.hpp"
+#include "Vision/VisionTypes.h"
 
 MAA_RES_NS_BEGIN
 
 class TemplateResMgr : public NonCopyable
 {
+public:
+    using TemplateList = std::vector<MAA_VISION_NS::PreparedTemplatePtr>;
+
 public:
     bool lazy_load(const std::filesystem::path& path);
     bool load_file(const std::filesystem::path& path);
@@ -18,15 +23,17 @@ public:
     void clear();
 
 public:
-    std::vector<cv::Mat> get_image(const std::string& name);
+    // 返回拷贝（只是几个 shared_ptr），set_image / clear 之后调用方手里的列表依然有效
+    TemplateList get_image(const std::string& name);
     void set_image(const std::string& name, const cv::Mat& image);
 
 private:
-    std::vector<cv::Mat> load(const std::string& name);
+    TemplateList load(const std::string& name);
 
     std::vector<std::filesystem::path> roots_ = { "" }; // for filepath without prefix
 
-    std::unordered_map<std::string, std::vector<cv::Mat>> image_cache_;
+    std::mutex cache_mutex_;
+    std::unordered_map<std::string, TemplateList> image_cache_;
 };
 
 MAA_RES_NS_END
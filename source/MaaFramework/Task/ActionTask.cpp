@@ -22,6 +22,19 @@ ActionTask::ActionTask(
 {
 }
 
+ActionTask::ActionTask(
+    const cv::Rect& box,
+    const std::string& reco_detail,
+    PipelineDataPtr node,
+    Tasker* tasker,
+    std::shared_ptr<Context> context)
+    : ActionTask(box, reco_detail, node ? node->name : std::string(), tasker, std::move(context))
+{
+    node_ = std::move(node);
+    // 回调里 get_node_data / override_next 还能按名字找到这个节点
+    context_->push_direct_node(node_);
+}
+
 bool ActionTask::run()
 {
     return run_impl() != MaaInvalidId;
@@ -36,7 +49,7 @@ MaaActId ActionTask::run_impl()
         return MaaInvalidId;
     }
 
-    auto node_opt = context_->get_pipeline_data(entry_);
+    auto node_opt = node_ ? node_ : context_->get_pipeline_data(entry_);
     if (!node_opt) {
         LogError << "get_pipeline_data failed, task not exist" << VAR(entry_);
         return MaaInvalidId;
@@ -16,6 +16,13 @@ public:
         std::string entry,
         Tasker* tasker,
         std::shared_ptr<Context> context = nullptr);
+    // 直接使用给定的节点，不再按 entry 在 pipeline 里查找
+    ActionTask(
+        const cv::Rect& box,
+        const std::string& reco_detail,
+        PipelineDataPtr node,
+        Tasker* tasker,
+        std::shared_ptr<Context> context = nullptr);
 
     virtual ~ActionTask() override = default;
 
@@ -28,6 +35,7 @@ public:
 private:
     cv::Rect box_;
     json::value reco_detail_;
+    PipelineDataPtr node_ = nullptr;
 };
 
 MAA_TASK_NS_END
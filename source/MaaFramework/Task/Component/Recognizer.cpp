@@ -1,5 +1,11 @@
 #include "Recognizer.h"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <tuple>
+
 #include "CustomRecognition.h"
 #include "Global/OptionMgr.h"
 #include "MaaUtils/ImageIo.h"
@@ -15,13 +21,21 @@
 
 MAA_TASK_NS_BEGIN
 
-Recognizer::Recognizer(Tasker* tasker, Context& context, const cv::Mat& image_, std::shared_ptr<MAA_VISION_NS::OCRCache> ocr_batch_cache)
+Recognizer::Recognizer(
+    Tasker* tasker,
+    Context& context,
+    const cv::Mat& image_,
+    std::shared_ptr<RecoPrefetchCache> prefetch_cache,
+    std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache,
+    std::shared_ptr<RegionRecoCache> region_cache)
     : tasker_(tasker)
     , context_(context)
     , image_(image_)
     , sub_filtered_boxes_(std::make_shared<typename decltype(sub_filtered_boxes_)::element_type>())
     , sub_best_box_(std::make_shared<typename decltype(sub_best_box_)::element_type>())
-    , ocr_batch_cache_(std::move(ocr_batch_cache))
+    , prefetch_cache_(std::move(prefetch_cache))
+    , feature_cache_(feature_cache ? std::move(feature_cache) : std::make_shared<MAA_VISION_NS::FeatureCache>())
+    , region_cache_(std::move(region_cache))
 {
 }
 
@@ -32,11 +46,19 @@ Recognizer::Recognizer(const Recognizer& recognizer)
     // do not copy reco_id_
     , sub_filtered_boxes_(recognizer.sub_filtered_boxes_)
     , sub_best_box_(recognizer.sub_best_box_)
-    , ocr_batch_cache_(recognizer.ocr_batch_cache_)
+    , prefetch_cache_(recognizer.prefetch_cache_)
+    , feature_cache_(recognizer.feature_cache_)
 {
 }
 
 RecoResult Recognizer::recognize(MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param, const std::string& name)
+{
+    RecoResult result = evaluate(type, param, name);
+    commit(result, name);
+    return result;
+}
+
+RecoResult Recognizer::evaluate(MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param, const std::string& name)
 {
     using namespace MAA_RES_NS::Recognition;
     using namespace MAA_VISION_NS;
@@ -46,6 +68,11 @@ RecoResult Recognizer::recognize(MAA_RES_NS::Recognition::Type type, const MAA_R
         return { };
     }
 
+    std::vector<cv::Rect> region_rois;
+    if (auto reused = reuse_region_result(type, param, name, region_rois)) {
+        return *std::move(reused);
+    }
+
     RecoResult result;
 
     switch (type) {
@@ -94,6 +121,128 @@ RecoResult Recognizer::recognize(MAA_RES_NS::Recognition::Type type, const MAA_R
         break;
     }
 
+    if (!region_rois.empty()) {
+        save_region_result(name, std::move(region_rois), result);
+    }
+
+    return result;
+}
+
+std::optional<RecoResult> Recognizer::reuse_region_result(
+    MAA_RES_NS::Recognition::Type type,
+    const MAA_RES_NS::Recognition::Param& param,
+    const std::string& name,
+    std::vector<cv::Rect>& rois)
+{
+    using namespace MAA_RES_NS::Recognition;
+    using namespace MAA_VISION_NS;
+
+    if (!region_cache_ || !region_cache_->fingerprint) {
+        return std::nullopt;
+    }
+
+    // 只有结果完全由 ROI 内像素决定的算法才能复用
+    // FeatureMatch 在整图上带 mask 提取特征点，ROI 外的像素也会影响结果，不能复用
+    const Target* roi_target = nullptr;
+    switch (type) {
+    case Type::TemplateMatch:
+        roi_target = &std::get<TemplateMatcherParam>(param).roi_target;
+        break;
+    case Type::ColorMatch:
+        roi_target = &std::get<ColorMatcherParam>(param).roi_target;
+        break;
+    case Type::OCR:
+        roi_target = &std::get<OCRerParam>(param).roi_target;
+        break;
+    case Type::NeuralNetworkClassify:
+        roi_target = &std::get<NeuralNetworkClassifierParam>(param).roi_target;
+        break;
+    case Type::NeuralNetworkDetect:
+        roi_target = &std::get<NeuralNetworkDetectorParam>(param).roi_target;
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    rois = get_rois(*roi_target);
+    if (rois.empty()) {
+        return std::nullopt;
+    }
+
+    const auto& fingerprint = *region_cache_->fingerprint;
+
+    std::unique_lock lock(region_cache_->mutex);
+    auto iter = region_cache_->entries.find(name);
+    if (iter == region_cache_->entries.end()) {
+        return std::nullopt;
+    }
+    const RegionRecoEntry& entry = iter->second;
+    if (!entry.fingerprint || entry.rois != rois) {
+        return std::nullopt;
+    }
+    bool unchanged = std::ranges::all_of(rois, [&](const cv::Rect& roi) { return fingerprint.same_in(*entry.fingerprint, roi); });
+    if (!unchanged) {
+        return std::nullopt;
+    }
+
+    LogDebug << "roi unchanged, reuse last result" << VAR(name) << VAR(rois);
+
+    sub_filtered_boxes_->insert_or_assign(name, entry.filtered_boxes);
+    sub_best_box_->insert_or_assign(name, entry.best_box);
+
+    RecoResult result = entry.result;
+    result.reco_id = reco_id_;
+    return result;
+}
+
+void Recognizer::save_region_result(const std::string& name, std::vector<cv::Rect> rois, const RecoResult& result)
+{
+    if (!region_cache_ || !region_cache_->fingerprint) {
+        return;
+    }
+
+    RegionRecoEntry entry {
+        .fingerprint = region_cache_->fingerprint,
+        .rois = std::move(rois),
+        .result = result,
+    };
+    if (auto iter = sub_filtered_boxes_->find(name); iter != sub_filtered_boxes_->end()) {
+        entry.filtered_boxes = iter->second;
+    }
+    if (auto iter = sub_best_box_->find(name); iter != sub_best_box_->end()) {
+        entry.best_box = iter->second;
+    }
+
+    std::unique_lock lock(region_cache_->mutex);
+    region_cache_->entries.insert_or_assign(name, std::move(entry));
+}
+
+void Recognizer::commit(RecoResult& result, const std::string& name)
+{
+    for (auto& [sub_result, sub_name] : pending_sub_commits_) {
+        commit_one(sub_result, sub_name);
+    }
+    pending_sub_commits_.clear();
+
+    commit_one(result, name);
+}
+
+void Recognizer::defer_sub_commit(Recognizer& sub_recognizer, const RecoResult& sub_result, const std::string& sub_name)
+{
+    // 嵌套的 And/Or 先提交更深层的子识别，和逐层 recognize 时的顺序一致
+    std::ranges::move(sub_recognizer.pending_sub_commits_, std::back_inserter(pending_sub_commits_));
+    sub_recognizer.pending_sub_commits_.clear();
+
+    pending_sub_commits_.emplace_back(sub_result, sub_name);
+}
+
+void Recognizer::commit_one(RecoResult& result, const std::string& name)
+{
+    if (!tasker_) {
+        LogError << "tasker is null";
+        return;
+    }
+
     if (debug_mode() && !image_.empty()) {
         ImageEncodedBuffer png;
         cv::imencode(".png", image_, png);
@@ -105,8 +254,6 @@ RecoResult Recognizer::recognize(MAA_RES_NS::Recognition::Type type, const MAA_R
     rt_cache.set_reco_detail(result.reco_id, result);
 
     save_draws(name, result);
-
-    return result;
 }
 
 template <typename Res>
@@ -186,8 +333,9 @@ RecoResult Recognizer::template_match(const MAA_VISION_NS::TemplateMatcherParam&
         return { };
     }
     auto templs = context_.get_images(param.template_);
+    auto score_cache = prefetch_cache_ ? std::shared_ptr<const TemplateScoreCache>(prefetch_cache_, &prefetch_cache_->template_score) : nullptr;
 
-    return build_result(name, "TemplateMatch", TemplateMatcher(image_, rois, param, templs, name));
+    return build_result(name, "TemplateMatch", TemplateMatcher(image_, rois, param, std::move(templs), name, std::move(score_cache)));
 }
 
 RecoResult Recognizer::feature_match(const MAA_VISION_NS::FeatureMatcherParam& param, const std::string& name)
@@ -206,7 +354,7 @@ RecoResult Recognizer::feature_match(const MAA_VISION_NS::FeatureMatcherParam& p
     }
     auto templs = context_.get_images(param.template_);
 
-    return build_result(name, "FeatureMatch", FeatureMatcher(image_, rois, param, templs, name));
+    return build_result(name, "FeatureMatch", FeatureMatcher(image_, rois, param, std::move(templs), name, feature_cache_));
 }
 
 RecoResult Recognizer::color_match(const MAA_VISION_NS::ColorMatcherParam& param, const std::string& name)
@@ -262,24 +410,23 @@ RecoResult Recognizer::ocr(const MAA_VISION_NS::OCRerParam& param, const std::st
         return { };
     }
 
-    if (ocr_batch_cache_ && ocr_batch_cache_->contains(name)) {
-        const auto& cached = ocr_batch_cache_->at(name);
+    if (prefetch_cache_ && prefetch_cache_->ocr.contains(name)) {
+        const auto& cached = prefetch_cache_->ocr.at(name);
         LogDebug << "OCR using batch cache" << VAR(name) << VAR(cached);
-        return build_result(name, "OCR", OCRer(image_, rois, param, cached, resource()->ocr_res().recer(param.model), name));
+        auto session = resource()->ocr_res().acquire(param.model);
+        return build_result(name, "OCR", OCRer(image_, rois, param, cached, session ? session->recer : nullptr, name));
+    }
+
+    auto session = resource()->ocr_res().acquire(param.model);
+    if (!session) {
+        LogError << "failed to acquire ocr session" << VAR(name) << VAR(param.model);
+        return { };
     }
 
     return build_result(
         name,
         "OCR",
-        OCRer(
-            image_,
-            rois,
-            param,
-            resource()->ocr_res().deter(param.model),
-            resource()->ocr_res().recer(param.model),
-            resource()->ocr_res().ocrer(param.model),
-            name,
-            std::move(color_filter)));
+        OCRer(image_, rois, param, session->deter, session->recer, session->ocrer, name, std::move(color_filter)));
 }
 
 RecoResult Recognizer::nn_classify(const MAA_VISION_NS::NeuralNetworkClassifierParam& param, const std::string& name)
@@ -303,11 +450,12 @@ RecoResult Recognizer::nn_classify(const MAA_VISION_NS::NeuralNetworkClassifierP
     }
 
     auto& onnx_res = resource()->onnx_res();
+    auto cache = prefetch_cache_ ? std::shared_ptr<const ONNXOutputCache>(prefetch_cache_, &prefetch_cache_->nn_classify) : nullptr;
 
     return build_result(
         name,
         "NeuralNetworkClassify",
-        NeuralNetworkClassifier(image_, rois, param, onnx_res.classifier(param.model), onnx_res.memory_info(), name));
+        NeuralNetworkClassifier(image_, rois, param, onnx_res.classifier(param.model), onnx_res.memory_info(), name, std::move(cache)));
 }
 
 RecoResult Recognizer::nn_detect(const MAA_VISION_NS::NeuralNetworkDetectorParam& param, const std::string& name)
@@ -331,11 +479,12 @@ RecoResult Recognizer::nn_detect(const MAA_VISION_NS::NeuralNetworkDetectorParam
     }
 
     auto& onnx_res = resource()->onnx_res();
+    auto cache = prefetch_cache_ ? std::shared_ptr<const ONNXOutputCache>(prefetch_cache_, &prefetch_cache_->nn_detect) : nullptr;
 
     return build_result(
         name,
         "NeuralNetworkDetect",
-        NeuralNetworkDetector(image_, rois, param, onnx_res.detector(param.model), onnx_res.memory_info(), name));
+        NeuralNetworkDetector(image_, rois, param, onnx_res.detector(param.model), onnx_res.memory_info(), name, std::move(cache)));
 }
 
 RecoResult Recognizer::custom_recognize(const MAA_VISION_NS::CustomRecognitionParam& param, const std::string& name)
@@ -386,12 +535,14 @@ RecoResult Recognizer::and_(const std::shared_ptr<MAA_RES_NS::Recognition::AndPa
                 break;
             }
             LogDebug << "And: run node reference" << VAR(*node_name);
-            res = sub_recognizer.recognize(node_opt->reco_type, node_opt->reco_param, *node_name);
+            res = sub_recognizer.evaluate(node_opt->reco_type, node_opt->reco_param, *node_name);
+            defer_sub_commit(sub_recognizer, res, *node_name);
         }
         else {
             const auto& inline_sub = std::get<InlineSubRecognition>(sub_reco);
             LogDebug << "And: run inline sub recognition" << VAR(inline_sub.type) << VAR(inline_sub.sub_name);
-            res = sub_recognizer.recognize(inline_sub.type, inline_sub.param, inline_sub.sub_name);
+            res = sub_recognizer.evaluate(inline_sub.type, inline_sub.param, inline_sub.sub_name);
+            defer_sub_commit(sub_recognizer, res, inline_sub.sub_name);
         }
 
         all_hit &= res.box.has_value();
@@ -468,12 +619,14 @@ RecoResult Recognizer::or_(const std::shared_ptr<MAA_RES_NS::Recognition::OrPara
                 continue;
             }
             LogDebug << "Or: run node reference" << VAR(*node_name);
-            res = sub_recognizer.recognize(node_opt->reco_type, node_opt->reco_param, *node_name);
+            res = sub_recognizer.evaluate(node_opt->reco_type, node_opt->reco_param, *node_name);
+            defer_sub_commit(sub_recognizer, res, *node_name);
         }
         else {
             const auto& inline_sub = std::get<InlineSubRecognition>(sub_reco);
             LogDebug << "Or: run inline sub recognition" << VAR(inline_sub.type) << VAR(inline_sub.sub_name);
-            res = sub_recognizer.recognize(inline_sub.type, inline_sub.param, inline_sub.sub_name);
+            res = sub_recognizer.evaluate(inline_sub.type, inline_sub.param, inline_sub.sub_name);
+            defer_sub_commit(sub_recognizer, res, inline_sub.sub_name);
         }
 
         has_hit = res.box.has_value();
@@ -621,7 +774,33 @@ MAA_RES_NS::ResourceMgr* Recognizer::resource()
     return tasker_ ? tasker_->resource() : nullptr;
 }
 
-void Recognizer::prefetch_batch_ocr(const std::vector<BatchOCREntry>& entries)
+void Recognizer::prefetch(const RecoPlan& plan)
+{
+    LogFunc << VAR(plan.node_names);
+
+    if (!prefetch_cache_ || !resource()) {
+        LogDebug << "prefetch skipped" << VAR(prefetch_cache_) << VAR(resource());
+        return;
+    }
+
+    for (const auto& [model, entries] : plan.ocr) {
+        prefetch_ocr(entries);
+    }
+    for (const auto& [model, entries] : plan.ocr_rec) {
+        prefetch_ocr_rec(model, entries);
+    }
+    for (const auto& [model, entries] : plan.nn_classify) {
+        prefetch_nn_classify(model, entries);
+    }
+    for (const auto& [model, entries] : plan.nn_detect) {
+        prefetch_nn_detect(model, entries);
+    }
+    if (!plan.template_match.empty()) {
+        prefetch_template_match(plan.template_match);
+    }
+}
+
+void Recognizer::prefetch_ocr(const std::vector<BatchOCREntry>& entries)
 {
     // 这个函数虽然叫 batch，最一开始的实现也确实是 gpu batch
     // 但后来发现，直接做 mask 效率更高，于是就走普通 OCR 了
@@ -629,8 +808,7 @@ void Recognizer::prefetch_batch_ocr(const std::vector<BatchOCREntry>& entries)
 
     using namespace MAA_VISION_NS;
 
-    if (!ocr_batch_cache_ || entries.empty() || !resource()) {
-        LogDebug << "prefetch_batch_ocr skipped" << VAR(ocr_batch_cache_) << VAR(entries.empty()) << VAR(resource());
+    if (entries.empty()) {
         return;
     }
 
@@ -666,14 +844,13 @@ void Recognizer::prefetch_batch_ocr(const std::vector<BatchOCREntry>& entries)
     batch_param.threshold = 0;
     batch_param.replace.clear();
 
-    OCRer ocrer(
-        masked_image,
-        { union_roi },
-        batch_param,
-        resource()->ocr_res().deter(batch_param.model),
-        resource()->ocr_res().recer(batch_param.model),
-        resource()->ocr_res().ocrer(batch_param.model),
-        batch_name);
+    auto session = resource()->ocr_res().acquire(batch_param.model);
+    if (!session) {
+        LogError << "failed to acquire ocr session" << VAR(batch_param.model);
+        return;
+    }
+
+    OCRer ocrer(masked_image, { union_roi }, batch_param, session->deter, session->recer, session->ocrer, batch_name);
 
     // 这里先把全部沾点边的结果（有交集的）都收集起来，后面实际要用的时候 (OCR::handle_cached) 再进一步划分
     auto intersect = [](const cv::Rect& a, const cv::Rect& b) {
@@ -681,7 +858,7 @@ void Recognizer::prefetch_batch_ocr(const std::vector<BatchOCREntry>& entries)
     };
 
     for (const auto& [node, rois] : node_rois) {
-        auto& cache = (*ocr_batch_cache_)[node];
+        auto& cache = prefetch_cache_->ocr[node];
         for (const MAA_VISION_NS::OCRerResult& res : ocrer.all_results()) {
             for (const auto& r : rois) {
                 if (!intersect(r, res.box)) {
@@ -692,7 +869,194 @@ void Recognizer::prefetch_batch_ocr(const std::vector<BatchOCREntry>& entries)
         }
     }
 
-    LogInfo << "prefetch_batch_ocr completed" << VAR(entries) << VAR(*ocr_batch_cache_);
+    LogInfo << "prefetch_ocr completed" << VAR(entries);
+}
+
+void Recognizer::prefetch_ocr_rec(const std::string& model, const std::vector<BatchOCREntry>& entries)
+{
+    using namespace MAA_VISION_NS;
+
+    std::string batch_name;
+    std::set<cv::Rect, RectComparator> all_rois;
+    std::unordered_map<std::string, std::vector<cv::Rect>> node_rois;
+
+    for (const auto& entry : entries) {
+        auto entry_rois = get_rois(entry.param.roi_target);
+        if (entry_rois.empty()) {
+            LogWarn << "failed to get rois for batch OCR entry" << VAR(entry.name);
+            continue;
+        }
+        all_rois.insert(entry_rois.begin(), entry_rois.end());
+        node_rois[entry.name] = std::move(entry_rois);
+        batch_name += entry.name + "+";
+    }
+
+    if (all_rois.empty()) {
+        LogWarn << "all_rois is empty" << VAR(entries);
+        return;
+    }
+
+    OCRerParam batch_param;
+    batch_param.model = model;
+    batch_param.only_rec = true;
+    batch_param.threshold = 0;
+
+    auto session = resource()->ocr_res().acquire(model);
+    if (!session) {
+        LogError << "failed to acquire ocr session" << VAR(model);
+        return;
+    }
+
+    // 所有节点的 ROI 一起送进一次 BatchPredict
+    std::vector<cv::Rect> batch_rois(all_rois.begin(), all_rois.end());
+    OCRer ocrer(image_, std::move(batch_rois), batch_param, session->deter, session->recer, session->ocrer, batch_name);
+
+    // 只识别不检测时每个 ROI 都应有一条结果。缺了说明 BatchPredict 失败了，不建缓存，让节点自己再识别一次
+    // 否则 handle_cached 拿到空缓存会直接当成没识别到
+    for (const auto& [node, rois] : node_rois) {
+        OCRer::ResultsVec results;
+        std::set<cv::Rect, RectComparator> covered;
+        for (const MAA_VISION_NS::OCRerResult& res : ocrer.all_results()) {
+            if (std::ranges::find(rois, res.box) != rois.end()) {
+                results.emplace_back(res);
+                covered.emplace(res.box);
+            }
+        }
+        if (covered.size() != std::set<cv::Rect, RectComparator>(rois.begin(), rois.end()).size()) {
+            LogWarn << "batch ocr rec incomplete, fallback to predict" << VAR(node) << VAR(rois) << VAR(covered.size());
+            continue;
+        }
+        prefetch_cache_->ocr[node] = std::move(results);
+    }
+
+    LogInfo << "prefetch_ocr_rec completed" << VAR(model) << VAR(entries);
+}
+
+void Recognizer::prefetch_nn_classify(const std::string& model, const std::vector<BatchNNClassifyEntry>& entries)
+{
+    auto& cache = prefetch_cache_->nn_classify[model];
+    prefetch_onnx(entries, resource()->onnx_res().classifier(model), cache);
+
+    LogInfo << "prefetch_nn_classify completed" << VAR(model) << VAR(entries) << VAR(cache.size());
+}
+
+void Recognizer::prefetch_nn_detect(const std::string& model, const std::vector<BatchNNDetectEntry>& entries)
+{
+    auto& cache = prefetch_cache_->nn_detect[model];
+    prefetch_onnx(entries, resource()->onnx_res().detector(model), cache);
+
+    LogInfo << "prefetch_nn_detect completed" << VAR(model) << VAR(entries) << VAR(cache.size());
+}
+
+template <typename Entry>
+void Recognizer::prefetch_onnx(
+    const std::vector<Entry>& entries,
+    const MAA_VISION_NS::ONNXSessionPtr& session,
+    std::map<cv::Rect, MAA_VISION_NS::ONNXOutput, MAA_VISION_NS::RectComparator>& cache)
+{
+    using namespace MAA_VISION_NS;
+
+    if (!session) {
+        LogError << "OrtSession not loaded" << VAR(entries);
+        return;
+    }
+
+    std::set<cv::Rect, RectComparator> all_rois;
+    for (const auto& entry : entries) {
+        auto entry_rois = get_rois(entry.param.roi_target);
+        if (entry_rois.empty()) {
+            LogWarn << "failed to get rois for batch onnx entry" << VAR(entry.name);
+            continue;
+        }
+        all_rois.insert(entry_rois.begin(), entry_rois.end());
+    }
+
+    if (all_rois.empty()) {
+        LogWarn << "all_rois is empty" << VAR(entries);
+        return;
+    }
+
+    // 模型输出只取决于 ROI 图像和模型，按 ROI 缓存原始输出，各节点自己再做后处理
+    std::vector<cv::Rect> batch_rois(all_rois.begin(), all_rois.end());
+    auto outputs = infer_rois(*session, resource()->onnx_res().memory_info(), image_, batch_rois);
+    if (outputs.size() != batch_rois.size()) {
+        LogWarn << "batch inference failed" << VAR(entries);
+        return;
+    }
+
+    for (size_t i = 0; i != batch_rois.size(); ++i) {
+        cache.emplace(batch_rois[i], std::move(outputs[i]));
+    }
+}
+
+void Recognizer::prefetch_template_match(const std::vector<BatchTemplateEntry>& entries)
+{
+    using namespace MAA_VISION_NS;
+
+    // (模板, method, green_mask) 相同的 ROI 才能共用得分图
+    using Key = std::tuple<PreparedTemplatePtr, int, bool>;
+    std::map<Key, std::vector<cv::Rect>> key_rois;
+
+    for (const auto& entry : entries) {
+        auto entry_rois = get_rois(entry.param.roi_target);
+        if (entry_rois.empty()) {
+            continue;
+        }
+        for (const auto& templ : context_.get_images(entry.param.template_)) {
+            Key key { templ, entry.param.method, entry.param.green_mask };
+            auto& rois = key_rois[key];
+            rois.insert(rois.end(), entry_rois.begin(), entry_rois.end());
+        }
+    }
+
+    struct Cluster
+    {
+        cv::Rect area;
+        int64_t sum_area = 0;
+        size_t count = 0;
+    };
+
+    size_t computed = 0;
+
+    for (const auto& [key, rois] : key_rois) {
+        const auto& [templ, method, green_mask] = key;
+
+        // 把相互重叠的 ROI 合并成若干块
+        std::vector<Cluster> clusters;
+        for (const cv::Rect& roi : rois) {
+            Cluster merged { .area = roi, .sum_area = roi.area(), .count = 1 };
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (auto it = clusters.begin(); it != clusters.end(); ++it) {
+                    if ((it->area & merged.area).empty()) {
+                        continue;
+                    }
+                    merged.area |= it->area;
+                    merged.sum_area += it->sum_area;
+                    merged.count += it->count;
+                    clusters.erase(it);
+                    changed = true;
+                    break;
+                }
+            }
+            clusters.emplace_back(merged);
+        }
+
+        for (const Cluster& cluster : clusters) {
+            // 只有一个 ROI，或者合并后面积比分开算还大，就没必要了
+            if (cluster.count < 2 || cluster.area.area() > cluster.sum_area) {
+                continue;
+            }
+            if (templ->image.cols > cluster.area.width || templ->image.rows > cluster.area.height) {
+                continue;
+            }
+            cv::Mat score = TemplateMatcher::match_score(image_(cluster.area), *templ, method, green_mask);
+            prefetch_cache_->template_score.set(templ, method, green_mask, cluster.area, std::move(score));
+            ++computed;
+        }
+    }
+
+    LogInfo << "prefetch_template_match completed" << VAR(entries) << VAR(computed);
 }
 
 MAA_TASK_NS_END
@@ -9,6 +9,7 @@
 #include "Task/Context.h"
 #include "Task/PipelineTask.h"
 #include "Tasker/Tasker.h"
+#include "Vision/FeatureMatcher.h"
 #include "Vision/OCRer.h"
 
 MAA_TASK_NS_BEGIN
@@ -17,13 +18,25 @@ class Recognizer
 {
 public:
 public:
-    Recognizer(Tasker* tasker, Context& context, const cv::Mat& image, std::shared_ptr<MAA_VISION_NS::OCRCache> ocr_batch_cache = nullptr);
+    Recognizer(
+        Tasker* tasker,
+        Context& context,
+        const cv::Mat& image,
+        std::shared_ptr<RecoPrefetchCache> prefetch_cache = nullptr,
+        std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache = nullptr,
+        std::shared_ptr<RegionRecoCache> region_cache = nullptr);
     Recognizer(const Recognizer& recognizer);
 
 public:
     RecoResult recognize(MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param, const std::string& name);
 
-    void prefetch_batch_ocr(const std::vector<BatchOCREntry>& entries);
+    // recognize = evaluate + commit。并行 NextList 里先 evaluate，确定要用的结果后再按顺序 commit
+    // And/Or 的子识别也只 evaluate，结果暂存到 commit 时和父识别一起提交
+    RecoResult evaluate(MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param, const std::string& name);
+    void commit(RecoResult& result, const std::string& name);
+
+    // 执行 RecoPlan，结果写入 prefetch_cache
+    void prefetch(const RecoPlan& plan);
 
     MaaRecoId get_id() const { return reco_id_; }
 
@@ -39,6 +52,27 @@ private:
     RecoResult or_(const std::shared_ptr<MAA_RES_NS::Recognition::OrParam>& param, const std::string& name);
     RecoResult custom_recognize(const MAA_VISION_NS::CustomRecognitionParam& param, const std::string& name);
 
+    void defer_sub_commit(Recognizer& sub_recognizer, const RecoResult& sub_result, const std::string& sub_name);
+    void commit_one(RecoResult& result, const std::string& name);
+
+    void prefetch_ocr(const std::vector<BatchOCREntry>& entries);
+    void prefetch_ocr_rec(const std::string& model, const std::vector<BatchOCREntry>& entries);
+    void prefetch_nn_classify(const std::string& model, const std::vector<BatchNNClassifyEntry>& entries);
+    void prefetch_nn_detect(const std::string& model, const std::vector<BatchNNDetectEntry>& entries);
+    template <typename Entry>
+    void prefetch_onnx(
+        const std::vector<Entry>& entries,
+        const MAA_VISION_NS::ONNXSessionPtr& session,
+        std::map<cv::Rect, MAA_VISION_NS::ONNXOutput, MAA_VISION_NS::RectComparator>& cache);
+    void prefetch_template_match(const std::vector<BatchTemplateEntry>& entries);
+
+    std::optional<RecoResult> reuse_region_result(
+        MAA_RES_NS::Recognition::Type type,
+        const MAA_RES_NS::Recognition::Param& param,
+        const std::string& name,
+        std::vector<cv::Rect>& rois);
+    void save_region_result(const std::string& name, std::vector<cv::Rect> rois, const RecoResult& result);
+
     template <typename Analyzer>
     RecoResult build_result(const std::string& name, const std::string& algorithm, Analyzer&& analyzer);
 
@@ -61,7 +95,11 @@ private:
     std::shared_ptr<std::unordered_map<std::string, std::vector<cv::Rect>>> sub_filtered_boxes_;
     std::shared_ptr<std::unordered_map<std::string, cv::Rect>> sub_best_box_;
 
-    std::shared_ptr<MAA_VISION_NS::OCRCache> ocr_batch_cache_;
+    std::shared_ptr<RecoPrefetchCache> prefetch_cache_;
+    std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache_;
+    std::shared_ptr<RegionRecoCache> region_cache_; // 只在顶层识别用，And/Or 的子识别不复用
+
+    std::vector<std::pair<RecoResult, std::string>> pending_sub_commits_;
 };
 
 MAA_TASK_NS_END
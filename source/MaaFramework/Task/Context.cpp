@@ -5,13 +5,13 @@
 #include "ActionTask.h"
 #include "Component/ActionHelper.h"
 #include "MaaUtils/Logger.h"
-#include "MaaUtils/Uuid.h"
 #include "PipelineTask.h"
 #include "RecognitionTask.h"
 #include "Resource/PipelineChecker.h"
 #include "Resource/PipelineDumper.h"
 #include "Resource/PipelineParser.h"
 #include "Tasker/Tasker.h"
+#include "Vision/VisionUtils.hpp"
 
 MAA_TASK_NS_BEGIN
 
@@ -50,8 +50,7 @@ Context::Context(const Context& other)
     : std::enable_shared_from_this<Context>(other)
     , task_id_(other.task_id_)
     , tasker_(other.tasker_)
-    , pipeline_override_(other.pipeline_override_)
-    , image_override_(other.image_override_)
+    , override_layer_(other.override_layer_)
     , task_state_(other.task_state_)
     , need_to_stop_(other.need_to_stop_)
 // don't copy clone_holder_
@@ -125,12 +124,25 @@ MaaRecoId Context::run_recognition_direct(const std::string& reco_type, const js
 {
     LogTrace << VAR(getptr()) << VAR(reco_type) << VAR(reco_param);
 
-    std::string entry = std::format("recognition/{}/{}", reco_type, make_uuid());
+    if (!tasker_) {
+        LogError << "tasker is null";
+        return MaaInvalidId;
+    }
+    auto* resource = tasker_->resource();
+    if (!resource) {
+        LogError << "resource not bound";
+        return MaaInvalidId;
+    }
 
-    json::value pipeline_override;
-    pipeline_override[entry]["recognition"] = { { "type", reco_type }, { "param", reco_param } };
+    // 不经过 pipeline override，同样的参数只解析一次
+    auto node = resource->get_direct_recognition_node(reco_type, reco_param);
+    if (!node) {
+        LogError << "failed to get_direct_recognition_node" << VAR(reco_type) << VAR(reco_param);
+        return MaaInvalidId;
+    }
 
-    return run_recognition(entry, pipeline_override, image);
+    RecognitionTask subtask(image, std::move(node), tasker_, make_clone());
+    return subtask.run_impl();
 }
 
 MaaActId Context::run_action_direct(
@@ -141,12 +153,24 @@ MaaActId Context::run_action_direct(
 {
     LogTrace << VAR(getptr()) << VAR(action_type) << VAR(action_param) << VAR(box) << VAR(reco_detail);
 
-    std::string entry = std::format("action/{}/{}", action_type, make_uuid());
+    if (!tasker_) {
+        LogError << "tasker is null";
+        return MaaInvalidId;
+    }
+    auto* resource = tasker_->resource();
+    if (!resource) {
+        LogError << "resource not bound";
+        return MaaInvalidId;
+    }
 
-    json::value pipeline_override;
-    pipeline_override[entry]["action"] = { { "type", action_type }, { "param", action_param } };
+    auto node = resource->get_direct_action_node(action_type, action_param);
+    if (!node) {
+        LogError << "failed to get_direct_action_node" << VAR(action_type) << VAR(action_param);
+        return MaaInvalidId;
+    }
 
-    return run_action(entry, pipeline_override, box, reco_detail);
+    ActionTask subtask(box, reco_detail, std::move(node), tasker_, make_clone());
+    return subtask.run_impl();
 }
 
 bool Context::wait_freezes(std::chrono::milliseconds time, const cv::Rect& box, const json::value& wait_freezes_param)
@@ -205,18 +229,21 @@ bool Context::override_pipeline(const json::value& pipeline_override)
     }
     auto& default_mgr = resource->default_pipeline();
 
+    // 整次调用只压一层，解析失败前已解析的节点仍然生效
+    PipelineDataMap changed;
     bool ret = false;
     if (pipeline_override.is_object()) {
-        ret = override_pipeline_once(pipeline_override.as_object(), default_mgr);
+        ret = override_pipeline_once(pipeline_override.as_object(), default_mgr, changed);
     }
     else if (pipeline_override.is_array()) {
         ret = true;
         for (const auto& val : pipeline_override.as_array()) {
             if (!val.is_object()) {
                 LogError << "input is not json array of object" << VAR(pipeline_override);
-                return false;
+                ret = false;
+                break;
             }
-            ret &= override_pipeline_once(val.as_object(), default_mgr);
+            ret &= override_pipeline_once(val.as_object(), default_mgr, changed);
         }
     }
     else {
@@ -224,7 +251,18 @@ bool Context::override_pipeline(const json::value& pipeline_override)
         return false;
     }
 
-    return ret && check_pipeline();
+    if (changed.empty()) {
+        return ret;
+    }
+
+    std::vector<std::string> names;
+    names.reserve(changed.size());
+    for (const auto& [name, data] : changed) {
+        names.emplace_back(name);
+    }
+    override_layer_ = OverrideLayer::push(override_layer_, std::move(changed));
+
+    return ret && check_pipeline(names);
 }
 
 bool Context::override_next(const std::string& node_name, const std::vector<std::string>& next)
@@ -237,24 +275,35 @@ bool Context::override_next(const std::string& node_name, const std::vector<std:
         return false;
     }
 
-    if (!MAA_RES_NS::PipelineParser::parse_next(next, data_opt->next)) {
+    PipelineData data = *data_opt;
+    if (!MAA_RES_NS::PipelineParser::parse_next(next, data.next)) {
         LogError << "failed to parse_next" << VAR(next);
         return false;
     }
 
-    pipeline_override_.insert_or_assign(node_name, std::move(*data_opt));
+    override_layer_ = OverrideLayer::push(override_layer_, { { node_name, std::make_shared<const PipelineData>(std::move(data)) } });
 
-    return check_pipeline();
+    return check_pipeline({ node_name });
 }
 
 bool Context::override_image(const std::string& image_name, const cv::Mat& image)
 {
     LogInfo << VAR(getptr()) << VAR(image_name) << VAR(image);
 
-    image_override_.insert_or_assign(image_name, image);
+    override_layer_ = OverrideLayer::push(override_layer_, { }, { { image_name, MAA_VISION_NS::prepare_template(image) } });
     return true;
 }
 
+void Context::push_direct_node(PipelineDataPtr node)
+{
+    if (!node) {
+        return;
+    }
+
+    std::string name = node->name;
+    override_layer_ = OverrideLayer::push(override_layer_, { { std::move(name), std::move(node) } });
+}
+
 std::optional<json::object> Context::get_node_data(const std::string& node_name) const
 {
     auto pp_opt = get_pipeline_data(node_name);
@@ -317,49 +366,116 @@ std::optional<std::string> Context::get_anchor(const std::string& anchor_name) c
     return std::nullopt;
 }
 
-std::optional<PipelineData> Context::get_pipeline_data(const std::string& node_name) const
+PipelineDataPtr Context::get_pipeline_data(const std::string& node_name) const
 {
-    auto override_it = pipeline_override_.find(node_name);
-    if (override_it != pipeline_override_.end()) {
-        LogDebug << "found in override" << VAR(node_name);
-        return override_it->second;
+    auto graph = this->graph();
+    if (!graph) {
+        return nullptr;
+    }
+
+    auto id = graph->find(node_name);
+    if (id == MAA_RES_NS::PipelineGraph::kInvalidId) {
+        LogWarn << "task not found" << VAR(node_name);
+        return nullptr;
     }
+    return graph->at(id);
+}
 
+PipelineDataPtr Context::get_pipeline_data(const MAA_RES_NS::NodeAttr& node_attr) const
+{
+    std::string node_name = node_attr.name;
+    if (node_attr.anchor) {
+        auto anchor_node = get_anchor(node_attr.name);
+        if (!anchor_node) {
+            LogDebug << "anchor not set" << VAR(node_attr.name);
+            return nullptr;
+        }
+        node_name = *anchor_node;
+    }
+    return get_pipeline_data(node_name);
+}
+
+MAA_RES_NS::PipelineGraphPtr Context::graph() const
+{
     if (!tasker_) {
         LogError << "tasker is null";
-        return std::nullopt;
+        return nullptr;
     }
     auto* resource = tasker_->resource();
     if (!resource) {
         LogError << "resource not bound";
-        return std::nullopt;
+        return nullptr;
     }
 
-    const auto& raw_pp_map = resource->pipeline_res().get_pipeline_data_map();
-    auto raw_it = raw_pp_map.find(node_name);
-    if (raw_it != raw_pp_map.end()) {
-        return raw_it->second;
+    const auto& base = resource->pipeline_res().get_graph();
+    return override_layer_ ? override_layer_->graph(base) : base;
+}
+
+MAA_RES_NS::CompiledList Context::compile_list(std::vector<MAA_RES_NS::NodeAttr> attrs) const
+{
+    using MAA_RES_NS::PipelineGraph;
+
+    auto graph = this->graph();
+    auto ids = graph ? graph->resolve(attrs) : std::vector<PipelineGraph::NodeId>(attrs.size(), PipelineGraph::kInvalidId);
+    return { .graph = std::move(graph), .attrs = std::move(attrs), .ids = std::move(ids) };
+}
+
+MAA_RES_NS::CompiledList Context::node_list(const PipelineDataPtr& node, bool on_error) const
+{
+    using MAA_RES_NS::PipelineGraph;
+
+    const auto& attrs = on_error ? node->on_error : node->next;
+
+    auto graph = this->graph();
+    auto id = graph ? graph->find(node->name) : PipelineGraph::kInvalidId;
+    if (id == PipelineGraph::kInvalidId || graph->at(id) != node) {
+        // 拿到 node 之后又被 override 了，按手上这份重新解析
+        return compile_list(attrs);
     }
 
-    LogWarn << "task not found" << VAR(node_name);
-    return std::nullopt;
+    auto ids = on_error ? graph->on_error(id) : graph->next(id);
+    return { .graph = std::move(graph), .attrs = attrs, .ids = std::vector(ids.begin(), ids.end()) };
 }
 
-std::optional<PipelineData> Context::get_pipeline_data(const MAA_RES_NS::NodeAttr& node_attr) const
+std::vector<PipelineDataPtr> Context::resolve_list(MAA_RES_NS::CompiledList& list) const
 {
-    std::string node_name = node_attr.name;
-    if (node_attr.anchor) {
-        auto anchor_node = get_anchor(node_attr.name);
-        if (!anchor_node) {
-            LogDebug << "anchor not set" << VAR(node_attr.name);
-            return std::nullopt;
+    using MAA_RES_NS::PipelineGraph;
+
+    std::vector<PipelineDataPtr> results(list.attrs.size());
+
+    auto graph = this->graph();
+    if (!graph) {
+        return results;
+    }
+    if (graph != list.graph) {
+        list.ids = graph->resolve(list.attrs);
+        list.graph = graph;
+    }
+
+    for (size_t i = 0; i < list.attrs.size(); ++i) {
+        const auto& attr = list.attrs[i];
+        auto id = list.ids[i];
+
+        if (attr.anchor) {
+            auto anchor_node = get_anchor(attr.name);
+            if (!anchor_node) {
+                LogDebug << "anchor not set" << VAR(attr.name);
+                continue;
+            }
+            id = graph->find(*anchor_node);
         }
-        node_name = *anchor_node;
+
+        if (id == PipelineGraph::kInvalidId) {
+            LogWarn << "task not found" << VAR(attr.name);
+            continue;
+        }
+        results[i] = graph->at(id);
     }
-    return get_pipeline_data(node_name);
+
+    return results;
 }
 
-std::vector<cv::Mat> Context::get_images(const std::vector<std::string>& names)
+std::vector<MAA_VISION_NS::PreparedTemplatePtr> Context::get_images(const std::vector<std::string>& names)
 {
     if (!tasker_) {
         LogError << "tasker is null";
@@ -371,18 +487,20 @@ std::vector<cv::Mat> Context::get_images(const std::vector<std::string>& names)
         return { };
     }
 
-    std::vector<cv::Mat> results;
+    std::vector<MAA_VISION_NS::PreparedTemplatePtr> results;
 
     for (const std::string& name : names) {
-        auto it = image_override_.find(name);
-        if (it != image_override_.end()) {
+        auto override_opt = override_layer_ ? override_layer_->find_image(name) : std::nullopt;
+        if (override_opt) {
             LogTrace << "image override" << VAR(name);
-            results.emplace_back(it->second);
+            if (*override_opt) {
+                results.emplace_back(*override_opt);
+            }
             continue;
         }
 
         auto imgs = resource->template_res().get_image(name);
-        results.insert(results.end(), std::make_move_iterator(imgs.begin()), std::make_move_iterator(imgs.end()));
+        results.insert(results.end(), imgs.begin(), imgs.end());
     }
 
     return results;
@@ -408,42 +526,43 @@ void Context::increment_hit_count(const std::string& node_name)
     task_state_->hit_count[node_name]++;
 }
 
-bool Context::override_pipeline_once(const json::object& pipeline_override, const MAA_RES_NS::DefaultPipelineMgr& default_mgr)
+bool Context::override_pipeline_once(
+    const json::object& pipeline_override,
+    const MAA_RES_NS::DefaultPipelineMgr& default_mgr,
+    PipelineDataMap& changed)
 {
     // LogTrace << VAR(getptr()) << VAR(pipeline_override);
 
     for (const auto& [key, value] : pipeline_override) {
         PipelineData result;
-        auto default_result = get_pipeline_data(key).value_or(default_mgr.get_pipeline());
+        // 同一次调用里先改过的节点还没压进 override_layer_，要先在 changed 里找
+        auto pending = changed.find(key);
+        auto exist = pending != changed.end() ? pending->second : get_pipeline_data(key);
+        const auto& default_result = exist ? *exist : default_mgr.get_pipeline();
         bool ret = MAA_RES_NS::PipelineParser::parse_node(key, value, result, default_result, default_mgr);
         if (!ret) {
             LogError << "parse_task failed" << VAR(key) << VAR(value);
             return false;
         }
 
-        pipeline_override_.insert_or_assign(key, std::move(result));
+        changed.insert_or_assign(key, std::make_shared<const PipelineData>(std::move(result)));
     }
 
     return true;
 }
 
-bool Context::check_pipeline() const
+bool Context::check_pipeline(const std::vector<std::string>& changed) const
 {
-    if (!tasker_) {
-        LogError << "tasker is null";
-        return false;
+    if (changed.empty()) {
+        return true;
     }
-    auto* resource = tasker_->resource();
-    if (!resource) {
-        LogError << "resource not bound";
+
+    auto graph = this->graph();
+    if (!graph) {
         return false;
     }
 
-    auto raw = resource->pipeline_res().get_pipeline_data_map();
-    auto all = pipeline_override_;
-    all.merge(raw);
-
-    return MAA_RES_NS::PipelineChecker::check_all_validity(all);
+    return MAA_RES_NS::PipelineChecker::check_nodes_validity(changed, *graph);
 }
 
 MAA_TASK_NS_END
@@ -6,6 +6,8 @@
 #include "Common/Conf.h"
 #include "Common/MaaTypes.h"
 #include "MaaFramework/MaaDef.h"
+#include "OverrideLayer.h"
+#include "Resource/PipelineGraph.h"
 #include "Resource/PipelineTypes.h"
 #include "Tasker/Tasker.h"
 
@@ -64,24 +66,39 @@ public: // from MaaContextAPI
     virtual std::optional<std::string> get_anchor(const std::string& anchor_name) const override;
 
 public:
-    std::optional<PipelineData> get_pipeline_data(const std::string& node_name) const;
-    std::optional<PipelineData> get_pipeline_data(const MAA_RES_NS::NodeAttr& node_attr) const;
-    std::vector<cv::Mat> get_images(const std::vector<std::string>& names);
+    // 返回共享的只读数据，不拷贝。节点不存在时为 nullptr
+    PipelineDataPtr get_pipeline_data(const std::string& node_name) const;
+    PipelineDataPtr get_pipeline_data(const MAA_RES_NS::NodeAttr& node_attr) const;
+
+    // 资源的 pipeline 图叠加上本 context 的 override
+    MAA_RES_NS::PipelineGraphPtr graph() const;
+    MAA_RES_NS::CompiledList compile_list(std::vector<MAA_RES_NS::NodeAttr> attrs) const;
+    // node 的 next / on_error，node 仍是图里那份时直接用预解析好的 id
+    MAA_RES_NS::CompiledList node_list(const PipelineDataPtr& node, bool on_error) const;
+    // 与 list.attrs 一一对应，不存在或锚点未设置的为 nullptr。图变了会顺带刷新 list.ids
+    std::vector<PipelineDataPtr> resolve_list(MAA_RES_NS::CompiledList& list) const;
+    std::vector<MAA_VISION_NS::PreparedTemplatePtr> get_images(const std::vector<std::string>& names);
+    // 直接识别 / 动作的节点已经解析检查过，只压一层 override 让它能按名字查到，图等到查询时才编译
+    void push_direct_node(PipelineDataPtr node);
 
     bool& need_to_stop();
     bool check_hit_count(const PipelineData& data);
     void increment_hit_count(const std::string& node_name);
 
 private:
-    bool override_pipeline_once(const json::object& pipeline_override, const MAA_RES_NS::DefaultPipelineMgr& default_mgr);
-    bool check_pipeline() const;
+    bool override_pipeline_once(
+        const json::object& pipeline_override,
+        const MAA_RES_NS::DefaultPipelineMgr& default_mgr,
+        PipelineDataMap& changed);
+    // 只检查 changed 里的节点，没被改过的节点在之前已经检查过了
+    bool check_pipeline(const std::vector<std::string>& changed) const;
 
     MaaTaskId task_id_ = 0;
     Tasker* tasker_ = nullptr;
 
     // context level
-    PipelineDataMap pipeline_override_;
-    std::unordered_map<std::string, cv::Mat> image_override_;
+    // pipeline / image 的 override，clone 时共享，写入时压一层新的
+    std::shared_ptr<const OverrideLayer> override_layer_ = nullptr;
 
     // task level
     std::shared_ptr<TaskState> task_state_ = nullptr;
@@ -0,0 +1,58 @@
+#include "OverrideLayer.h"
+
+#include "MaaUtils/Logger.h"
+
+MAA_TASK_NS_BEGIN
+
+std::shared_ptr<const OverrideLayer>
+    OverrideLayer::push(std::shared_ptr<const OverrideLayer> parent, PipelineDataMap pipeline, ImageMap images)
+{
+    auto layer = std::make_shared<OverrideLayer>();
+
+    if (parent && parent->depth_ >= kMaxDepth) {
+        // 新层的内容优先，下面各层只补新层没有的
+        for (const OverrideLayer* p = parent.get(); p; p = p->parent_.get()) {
+            for (const auto& [name, data] : p->pipeline_) {
+                pipeline.try_emplace(name, data);
+            }
+            for (const auto& [name, image] : p->images_) {
+                images.try_emplace(name, image);
+            }
+        }
+        LogDebug << "override layers flattened" << VAR(pipeline.size()) << VAR(images.size());
+        parent = nullptr;
+    }
+
+    layer->depth_ = parent ? parent->depth_ + 1 : 1;
+    layer->parent_ = std::move(parent);
+    layer->pipeline_ = std::move(pipeline);
+    layer->images_ = std::move(images);
+    return layer;
+}
+
+std::optional<MAA_VISION_NS::PreparedTemplatePtr> OverrideLayer::find_image(const std::string& name) const
+{
+    for (const OverrideLayer* p = this; p; p = p->parent_.get()) {
+        if (auto it = p->images_.find(name); it != p->images_.end()) {
+            return it->second;
+        }
+    }
+    return std::nullopt;
+}
+
+MAA_RES_NS::PipelineGraphPtr OverrideLayer::graph(const MAA_RES_NS::PipelineGraphPtr& resource_graph) const
+{
+    auto base = parent_ ? parent_->graph(resource_graph) : resource_graph;
+    if (pipeline_.empty() || !base) {
+        return base;
+    }
+
+    std::unique_lock lock(graph_mutex_);
+    if (!graph_ || graph_base_ != base) {
+        graph_ = MAA_RES_NS::PipelineGraph::compile(pipeline_, base);
+        graph_base_ = base;
+    }
+    return graph_;
+}
+
+MAA_TASK_NS_END
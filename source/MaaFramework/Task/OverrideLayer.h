@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "Common/Conf.h"
+#include "Resource/PipelineGraph.h"
+#include "Resource/PipelineTypes.h"
+#include "Vision/VisionTypes.h"
+
+MAA_TASK_NS_BEGIN
+
+// Context 的一层 override，创建后只读
+// clone 出来的 Context 直接共享整条链，写入时在顶上压一层新的，不复制下面的内容
+class OverrideLayer
+{
+public:
+    using ImageMap = std::unordered_map<std::string, MAA_VISION_NS::PreparedTemplatePtr>;
+
+    // 链太长时把下面的层合并进新层，保证查找只走很短的链
+    inline static constexpr size_t kMaxDepth = 8;
+
+    static std::shared_ptr<const OverrideLayer>
+        push(std::shared_ptr<const OverrideLayer> parent, PipelineDataMap pipeline, ImageMap images = { });
+
+public:
+    // 外层为 nullopt 表示没有被 override 过
+    std::optional<MAA_VISION_NS::PreparedTemplatePtr> find_image(const std::string& name) const;
+
+    // 各层 pipeline override 逐层叠加在 resource_graph 上的图，每层按需编译一次，资源变了会重新编译
+    MAA_RES_NS::PipelineGraphPtr graph(const MAA_RES_NS::PipelineGraphPtr& resource_graph) const;
+
+private:
+    std::shared_ptr<const OverrideLayer> parent_ = nullptr;
+    size_t depth_ = 1;
+
+    PipelineDataMap pipeline_;
+    ImageMap images_;
+
+    mutable std::mutex graph_mutex_;
+    mutable MAA_RES_NS::PipelineGraphPtr graph_ = nullptr;
+    mutable MAA_RES_NS::PipelineGraphPtr graph_base_ = nullptr; // graph_ 叠加在哪张图上
+};
+
+MAA_TASK_NS_END
@@ -1,5 +1,6 @@
 #include "PipelineTask.h"
 
+#include <atomic>
 #include <stack>
 
 #include "Component/Recognizer.h"
@@ -13,6 +14,7 @@
 #include "Resource/PipelineParser.h"
 #include "Resource/ResourceMgr.h"
 #include "Tasker/Tasker.h"
+#include "Vision/VisionUtils.hpp"
 
 MAA_TASK_NS_BEGIN
 
@@ -28,23 +30,22 @@ bool PipelineTask::run()
     std::stack<std::string> jumpback_stack;
 
     // there is no pretask for the entry, so we use the entry itself
-    auto begin_opt = context_->get_pipeline_data(entry_);
-    if (!begin_opt) {
+    PipelineDataPtr node = context_->get_pipeline_data(entry_);
+    if (!node) {
         LogError << "get_pipeline_data failed, task not exist" << VAR(entry_);
         return false;
     }
 
-    PipelineData node = std::move(*begin_opt);
-    std::vector<MAA_RES_NS::NodeAttr> next = { { .name = entry_ } };
+    auto next = context_->compile_list({ { .name = entry_ } });
 
     bool error_handling = false;
 
-    while (!next.empty() && !context_->need_to_stop()) {
-        cur_node_ = node.name;
-        auto node_detail = run_next(next, node);
+    while (!next.attrs.empty() && !context_->need_to_stop()) {
+        cur_node_ = node->name;
+        auto node_detail = run_next(next, *node);
 
         if (context_->need_to_stop()) {
-            LogWarn << "need_to_stop" << VAR(node.name);
+            LogWarn << "need_to_stop" << VAR(node->name);
             return true;
         }
 
@@ -56,8 +57,8 @@ bool PipelineTask::run()
                 LogError << "get_pipeline_data failed, task not exist" << VAR(node_detail.name);
                 return false;
             }
-            std::string pre_node_name = node.name;
-            node = std::move(*hit_opt);
+            std::string pre_node_name = node->name;
+            node = std::move(hit_opt);
 
             if (node_detail.jump_back) {
                 LogInfo << "push jumpback_stack:" << pre_node_name;
@@ -65,28 +66,28 @@ bool PipelineTask::run()
             }
 
             if (node_detail.completed) {
-                next = node.next;
+                next = context_->node_list(node, false);
             }
             else { // 动作执行失败了
-                LogWarn << "node not completed, handle error" << VAR(node.name);
+                LogWarn << "node not completed, handle error" << VAR(node->name);
                 error_handling = true;
-                next = node.on_error;
-                save_on_error(node.name);
+                next = context_->node_list(node, true);
+                save_on_error(node->name);
             }
         }
         else if (error_handling) {
-            LogError << "error handling loop detected" << VAR(node.name);
-            next.clear();
-            save_on_error(node.name);
+            LogError << "error handling loop detected" << VAR(node->name);
+            next = { };
+            save_on_error(node->name);
         }
         else {
-            LogWarn << "invalid node id, handle error" << VAR(node.name);
+            LogWarn << "invalid node id, handle error" << VAR(node->name);
             error_handling = true;
-            next = node.on_error;
-            save_on_error(node.name);
+            next = context_->node_list(node, true);
+            save_on_error(node->name);
         }
 
-        if (next.empty() && !error_handling && !jumpback_stack.empty()) {
+        if (next.attrs.empty() && !error_handling && !jumpback_stack.empty()) {
             auto top = std::move(jumpback_stack.top());
             LogInfo << "pop jumpback_stack:" << top;
             jumpback_stack.pop();
@@ -96,9 +97,9 @@ bool PipelineTask::run()
                 LogError << "get_pipeline_data failed, task not exist" << VAR(top);
                 return false;
             }
-            node = std::move(*top_opt);
+            node = std::move(top_opt);
 
-            next = node.next;
+            next = context_->node_list(node, false);
         }
     }
 
@@ -114,19 +115,17 @@ void PipelineTask::post_stop()
     context_->need_to_stop() = true;
 }
 
-NodeDetail PipelineTask::run_next(const std::vector<MAA_RES_NS::NodeAttr>& next, const PipelineData& pretask)
+NodeDetail PipelineTask::run_next(MAA_RES_NS::CompiledList& next, const PipelineData& pretask)
 {
     if (!context_) {
         LogError << "context is null";
         return { };
     }
 
-    bool valid = std::ranges::any_of(next, [&](const MAA_RES_NS::NodeAttr& node) {
-        auto data_opt = context_->get_pipeline_data(node);
-        return data_opt && data_opt->enabled;
-    });
+    auto resolved = context_->resolve_list(next);
+    bool valid = std::ranges::any_of(resolved, [&](const PipelineDataPtr& data) { return data && data->enabled; });
     if (!valid) {
-        LogInfo << "no valid/enabled node in next" << VAR(next);
+        LogInfo << "no valid/enabled node in next" << VAR(next.attrs);
         return { };
     }
 
@@ -150,11 +149,51 @@ NodeDetail PipelineTask::run_next(const std::vector<MAA_RES_NS::NodeAttr>& next,
 
     notify(MaaMsg_Node_PipelineNode_Starting, node_cb_detail);
 
+    // 画面与上一次没命中时完全一致，识别结果也必然一致，直接跳过
+    // 自定义识别可能依赖外部状态，不做这个优化
+    bool deterministic = false;
+    std::shared_ptr<const MAA_CTRL_NS::FrameFingerprint> last_miss_fingerprint = nullptr;
+    std::vector<PipelineDataPtr> last_miss_resolved;
+    // 所有节点都只看固定区域时，控制器支持的话只截这些区域
+    std::optional<cv::Rect> capture_roi = std::nullopt;
+    // 上面几项是按哪一版解析结果算的，解析结果变了要重新算
+    std::vector<PipelineDataPtr> planned_resolved;
+
     while (!context_->need_to_stop()) {
         auto current_clock = std::chrono::steady_clock::now();
-        cv::Mat image = screencap();
+        // 锚点和 override 在循环中可能会变，每轮重新解析。静态的边只是按 id 取数组，没有字符串查找
+        resolved = context_->resolve_list(next);
+        if (planned_resolved.empty() || resolved != planned_resolved) {
+            planned_resolved = resolved;
+            deterministic = is_reco_list_deterministic(resolved);
+            // 画面只变了一部分时，ROI 没被波及的节点复用上一轮的结果。节点数据换了，旧结果一律作废
+            region_cache_ = deterministic ? std::make_shared<RegionRecoCache>() : nullptr;
+            // 需要上一帧的尺寸来换算负数/0 宽高的 ROI
+            capture_roi = std::nullopt;
+            if (deterministic && controller()) {
+                const cv::Mat last_image = controller()->cached_image();
+                if (!last_image.empty()) {
+                    capture_roi = reco_list_roi_union(resolved, last_image.size());
+                }
+            }
+        }
 
-        RecoResult reco = recognize_list(image, next);
+        auto frame = screencap_frame(capture_roi.value_or(cv::Rect { }));
+        cached_image_stale_ = frame.partial;
+        if (region_cache_) {
+            region_cache_->fingerprint = frame.fingerprint;
+        }
+
+        RecoResult reco;
+        if (deterministic && last_miss_fingerprint && frame.fingerprint && resolved == last_miss_resolved
+            && frame.fingerprint->same_as(*last_miss_fingerprint)) {
+            LogDebug << "screen and nodes unchanged since last miss, skip recognition" << VAR(cur_node_);
+        }
+        else {
+            reco = recognize_list(frame.image, next.attrs, resolved);
+            last_miss_fingerprint = reco.box ? nullptr : frame.fingerprint;
+            last_miss_resolved = reco.box ? std::vector<PipelineDataPtr> { } : resolved;
+        }
 
         if (context_->need_to_stop()) {
             LogWarn << "need_to_stop" << VAR(pretask.name);
@@ -185,13 +224,17 @@ NodeDetail PipelineTask::run_next(const std::vector<MAA_RES_NS::NodeAttr>& next,
         }
 
         // Resolve jump_back BEFORE action execution (anchors are still intact at this point)
-        bool jump_back = std::ranges::any_of(next, [&](const MAA_RES_NS::NodeAttr& n) {
-            if (!n.jump_back) {
-                return false;
+        bool jump_back = false;
+        for (size_t i = 0; i < next.attrs.size(); ++i) {
+            if (next.attrs[i].jump_back && resolved[i] && resolved[i]->name == hit_name) {
+                jump_back = true;
+                break;
             }
-            auto data_opt = context_->get_pipeline_data(n);
-            return data_opt && data_opt->name == hit_name;
-        });
+        }
+
+        if (action_reads_cached_image(hit_opt->action_type)) {
+            refresh_cached_image();
+        }
 
         auto act = run_action(reco, *hit_opt);
 
@@ -232,7 +275,10 @@ NodeDetail PipelineTask::run_next(const std::vector<MAA_RES_NS::NodeAttr>& next,
     return result;
 }
 
-RecoResult PipelineTask::recognize_list(const cv::Mat& image, const std::vector<MAA_RES_NS::NodeAttr>& list)
+RecoResult PipelineTask::recognize_list(
+    const cv::Mat& image,
+    const std::vector<MAA_RES_NS::NodeAttr>& list,
+    const std::vector<PipelineDataPtr>& resolved)
 {
     LogFunc << VAR(cur_node_) << VAR(list);
 
@@ -258,28 +304,52 @@ RecoResult PipelineTask::recognize_list(const cv::Mat& image, const std::vector<
 
     notify(MaaMsg_Node_NextList_Starting, reco_list_cb_detail);
 
-    auto batch_plan = prepare_batch_ocr(list);
-    auto ocr_cache = batch_plan ? std::make_shared<MAA_VISION_NS::OCRCache>() : nullptr;
-    bool batch_triggered = false;
+    auto reco_plan = prepare_reco_plan(resolved);
+    auto prefetch_cache = reco_plan ? std::make_shared<RecoPrefetchCache>() : nullptr;
+    bool plan_triggered = false;
+    // 同一帧内各节点共用截图的特征点
+    auto feature_cache = std::make_shared<MAA_VISION_NS::FeatureCache>();
+
+    if (MAA_GLOBAL_NS::OptionMgr::get_instance().parallel_next_list()) {
+        if (auto candidates = collect_parallel_candidates(resolved)) {
+            if (reco_plan) {
+                Recognizer recognizer(tasker_, *context_, image, prefetch_cache);
+                recognizer.prefetch(*reco_plan);
+            }
+
+            RecoResult result = recognize_parallel(image, *candidates, prefetch_cache, feature_cache);
+
+            if (context_->need_to_stop()) {
+                LogWarn << "need_to_stop";
+            }
+            else if (result.box) {
+                notify(MaaMsg_Node_NextList_Succeeded, reco_list_cb_detail);
+                return result;
+            }
+
+            notify(MaaMsg_Node_NextList_Failed, reco_list_cb_detail);
+            return { };
+        }
+    }
 
-    for (const auto& node : list) {
+    for (size_t i = 0; i < list.size(); ++i) {
         if (context_->need_to_stop()) {
             LogWarn << "need_to_stop";
             break;
         }
 
-        auto node_opt = context_->get_pipeline_data(node);
-        if (!node_opt) {
-            LogError << "get_pipeline_data failed, node not exist" << VAR(node);
+        if (!resolved[i]) {
+            LogError << "get_pipeline_data failed, node not exist" << VAR(list[i]);
             continue;
         }
-        const auto& pipeline_data = *node_opt;
+        const auto& pipeline_data = *resolved[i];
 
-        if (batch_plan && !batch_triggered && batch_plan->node_names.contains(pipeline_data.name)) {
-            batch_triggered = true;
+        // 用到规划里的节点时才真正执行，前面的节点命中了就省掉了
+        if (reco_plan && !plan_triggered && reco_plan->node_names.contains(pipeline_data.name)) {
+            plan_triggered = true;
 
-            Recognizer recognizer(tasker_, *context_, image, ocr_cache);
-            recognizer.prefetch_batch_ocr(batch_plan->entries);
+            Recognizer recognizer(tasker_, *context_, image, prefetch_cache);
+            recognizer.prefetch(*reco_plan);
         }
 
         if (!pipeline_data.enabled) {
@@ -291,7 +361,7 @@ RecoResult PipelineTask::recognize_list(const cv::Mat& image, const std::vector<
             continue;
         }
 
-        RecoResult result = run_recognition(image, pipeline_data, ocr_cache);
+        RecoResult result = run_recognition(image, pipeline_data, prefetch_cache, feature_cache, region_cache_);
 
         if (result.box) {
             LogInfo << "reco hit" << VAR(result.name) << VAR(result.box);
@@ -316,120 +386,404 @@ RecoResult PipelineTask::recognize_list(const cv::Mat& image, const std::vector<
     return { };
 }
 
-std::optional<PipelineTask::BatchOCRPlan> PipelineTask::prepare_batch_ocr(const std::vector<MAA_RES_NS::NodeAttr>& list)
+std::optional<std::vector<PipelineDataPtr>> PipelineTask::collect_parallel_candidates(const std::vector<PipelineDataPtr>& list)
 {
-    using namespace MAA_RES_NS::Recognition;
+    std::vector<PipelineDataPtr> candidates;
 
-    if (!context_) {
-        return std::nullopt;
-    }
-
-    OCRCollectContext ctx;
-
-    for (const auto& node : list) {
-        auto data_opt = context_->get_pipeline_data(node);
+    for (const auto& data_opt : list) {
         if (!data_opt) {
             continue;
         }
-        const auto& data = *data_opt;
 
-        if (!data.enabled) {
+        if (!data_opt->enabled) {
+            LogDebug << "node disabled" << data_opt->name << VAR(data_opt->enabled);
             continue;
         }
 
-        if (!context_->check_hit_count(data)) {
+        if (!context_->check_hit_count(*data_opt)) {
             continue;
         }
 
-        collect_ocr_from_reco(ctx, data.name, data.reco_type, data.reco_param);
+        // Custom 识别会回调到用户代码里，用户可能会在回调里操作 context，不能并发
+        if (has_custom_recognition(data_opt->reco_type, data_opt->reco_param)) {
+            LogDebug << "parallel next list disabled by custom recognition" << VAR(data_opt->name);
+            return std::nullopt;
+        }
+
+        candidates.emplace_back(data_opt);
     }
 
-    if (ctx.plan.node_names.size() < 2) {
-        LogDebug << "batch OCR not needed, eligible OCR nodes < 2" << VAR(ctx.plan.node_names.size());
+    if (candidates.size() < 2) {
         return std::nullopt;
     }
 
-    for (const auto& name : ctx.plan.node_names) {
-        auto node_opt = context_->get_pipeline_data(name);
-        if (!node_opt) {
+    return candidates;
+}
+
+bool PipelineTask::is_reco_list_deterministic(const std::vector<PipelineDataPtr>& list)
+{
+    return std::ranges::none_of(list, [&](const PipelineDataPtr& data) {
+        return data && has_custom_recognition(data->reco_type, data->reco_param);
+    });
+}
+
+std::optional<cv::Rect> PipelineTask::reco_list_roi_union(const std::vector<PipelineDataPtr>& list, const cv::Size& image_size)
+{
+    cv::Rect roi_union;
+
+    for (const auto& data_opt : list) {
+        if (!data_opt) {
+            return std::nullopt;
+        }
+        if (!data_opt->enabled) {
             continue;
         }
-        ctx.plan.entries.emplace_back(
-            BatchOCREntry {
-                .name = name,
-                .param = std::get<MAA_VISION_NS::OCRerParam>(node_opt->reco_param),
-            });
+        if (!merge_reco_roi(roi_union, data_opt->reco_type, data_opt->reco_param, image_size)) {
+            return std::nullopt;
+        }
     }
 
-    LogInfo << "prepared batch OCR plan" << VAR(ctx.plan.node_names) << VAR(ctx.plan.model);
-    return ctx.plan;
+    if (roi_union.empty()) {
+        return std::nullopt;
+    }
+    return roi_union;
 }
 
-void PipelineTask::try_add_ocr_node(OCRCollectContext& ctx, const std::string& name, const MAA_VISION_NS::OCRerParam& param)
+bool PipelineTask::merge_reco_roi(
+    cv::Rect& roi_union,
+    MAA_RES_NS::Recognition::Type type,
+    const MAA_RES_NS::Recognition::Param& param,
+    const cv::Size& image_size)
 {
-    if (param.roi_target.type == MAA_VISION_NS::TargetType::PreTask) {
-        const auto& ref_name = std::get<std::string>(param.roi_target.param);
-        if (ctx.plan.node_names.contains(ref_name)) {
-            LogDebug << "batch OCR skipping node with PreTask ROI dependency" << VAR(name) << VAR(ref_name);
-            return;
+    using namespace MAA_RES_NS::Recognition;
+    using namespace MAA_VISION_NS;
+
+    auto merge_subs = [&](const std::vector<SubRecognition>& subs) {
+        return std::ranges::all_of(subs, [&](const SubRecognition& sub) {
+            if (auto* node_name = std::get_if<std::string>(&sub)) {
+                auto sub_opt = context_->get_pipeline_data(*node_name);
+                return sub_opt && merge_reco_roi(roi_union, sub_opt->reco_type, sub_opt->reco_param, image_size);
+            }
+            const auto& inline_sub = std::get<InlineSubRecognition>(sub);
+            return merge_reco_roi(roi_union, inline_sub.type, inline_sub.param, image_size);
+        });
+    };
+
+    switch (type) {
+    case Type::DirectHit:
+        // 不看画面
+        return true;
+    case Type::And: {
+        const auto& and_param = std::get<std::shared_ptr<AndParam>>(param);
+        return and_param && merge_subs(and_param->all_of);
+    }
+    case Type::Or: {
+        const auto& or_param = std::get<std::shared_ptr<OrParam>>(param);
+        return or_param && merge_subs(or_param->any_of);
+    }
+    case Type::FeatureMatch:
+        // 特征点描述子会用到 ROI 边缘外的像素，区域外是黑的会影响结果
+    case Type::Custom:
+    case Type::Invalid:
+        return false;
+    default:
+        break;
+    }
+
+    const RoiTargetParamBase* base = std::visit(
+        [](const auto& p) -> const RoiTargetParamBase* {
+            if constexpr (std::is_base_of_v<RoiTargetParamBase, std::decay_t<decltype(p)>>) {
+                return &p;
+            }
+            else {
+                return nullptr;
+            }
+        },
+        param);
+
+    // PreTask、Anchor 的 ROI 要到识别时才知道
+    if (!base || base->roi_target.type != TargetType::Region) {
+        return false;
+    }
+    const auto* rect = std::get_if<cv::Rect>(&base->roi_target.param);
+    if (!rect) {
+        return false;
+    }
+
+    const auto& offset = base->roi_target.offset;
+    cv::Rect roi(rect->x + offset.x, rect->y + offset.y, rect->width + offset.width, rect->height + offset.height);
+    roi = normalize_rect(roi, image_size.width, image_size.height) & cv::Rect({ }, image_size);
+    if (roi.empty()) {
+        return false;
+    }
+
+    roi_union = roi_union.empty() ? roi : (roi_union | roi);
+    return true;
+}
+
+bool PipelineTask::has_custom_recognition(MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param)
+{
+    using namespace MAA_RES_NS::Recognition;
+
+    auto sub_has_custom = [&](const std::vector<SubRecognition>& subs) {
+        return std::ranges::any_of(subs, [&](const SubRecognition& sub) {
+            if (auto* node_name = std::get_if<std::string>(&sub)) {
+                auto sub_opt = context_->get_pipeline_data(*node_name);
+                return sub_opt && has_custom_recognition(sub_opt->reco_type, sub_opt->reco_param);
+            }
+            const auto& inline_sub = std::get<InlineSubRecognition>(sub);
+            return has_custom_recognition(inline_sub.type, inline_sub.param);
+        });
+    };
+
+    switch (type) {
+    case Type::Custom:
+        return true;
+    case Type::And: {
+        const auto& and_param = std::get<std::shared_ptr<AndParam>>(param);
+        return and_param && sub_has_custom(and_param->all_of);
+    }
+    case Type::Or: {
+        const auto& or_param = std::get<std::shared_ptr<OrParam>>(param);
+        return or_param && sub_has_custom(or_param->any_of);
+    }
+    default:
+        return false;
+    }
+}
+
+RecoResult PipelineTask::recognize_parallel(
+    const cv::Mat& image,
+    const std::vector<PipelineDataPtr>& candidates,
+    std::shared_ptr<RecoPrefetchCache> prefetch_cache,
+    std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache)
+{
+    LogFunc << VAR(cur_node_) << VAR(candidates.size());
+
+    struct Slot
+    {
+        std::unique_ptr<Recognizer> recognizer;
+        RecoResult result;
+    };
+
+    const size_t count = candidates.size();
+    std::vector<Slot> slots(count);
+
+    // 按列表顺序认领任务；一旦有更靠前的节点命中，后面还没开始的就不用做了
+    std::atomic_size_t next_index = 0;
+    std::atomic_size_t first_hit = count;
+
+    auto work = [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; ++r) {
+            size_t index = next_index.fetch_add(1);
+            if (index >= first_hit.load() || context_->need_to_stop()) {
+                continue;
+            }
+
+            const auto& data = *candidates.at(index);
+            auto& slot = slots.at(index);
+
+            slot.recognizer = std::make_unique<Recognizer>(tasker_, *context_, image, prefetch_cache, feature_cache, region_cache_);
+            slot.result = slot.recognizer->evaluate(data.reco_type, data.reco_param, data.name);
+
+            bool hit = slot.result.box.has_value() != data.inverse;
+            if (!hit) {
+                continue;
+            }
+
+            size_t current = first_hit.load();
+            while (index < current && !first_hit.compare_exchange_weak(current, index)) {
+            }
+        }
+    };
+    cv::parallel_for_(cv::Range(0, static_cast<int>(count)), work, static_cast<double>(count));
+
+    // 回调和 RuntimeCache 按列表顺序提交，和顺序执行时看到的一致；命中之后的结果直接丢弃
+    const size_t hit_index = first_hit.load();
+    for (size_t i = 0; i < count && i <= hit_index; ++i) {
+        auto& slot = slots.at(i);
+        if (!slot.recognizer) {
+            continue;
+        }
+
+        const auto& data = *candidates.at(i);
+        notify_recognition_starting(*slot.recognizer, data);
+        RecoResult result = finish_recognition(*slot.recognizer, std::move(slot.result), data);
+
+        if (i == hit_index) {
+            LogInfo << "reco hit" << VAR(result.name) << VAR(result.box);
+            context_->increment_hit_count(data.name);
+            return result;
         }
     }
 
-    if (param.only_rec) {
-        // 这玩意 Batch 出来结果顺序可能是乱的，不知道哪个是哪个
-        // 我猜的，没试过，后面有空再看看
-        return;
+    return { };
+}
+
+std::optional<RecoPlan> PipelineTask::prepare_reco_plan(const std::vector<PipelineDataPtr>& list)
+{
+    if (!context_) {
+        return std::nullopt;
     }
 
-    if (!param.color_filter.empty()) {
-        // color_filter 需要对每个 ROI 单独做颜色二值化，无法与其他节点共享 mask 图
-        return;
+    RecoPlan plan;
+
+    for (const auto& data_opt : list) {
+        if (!data_opt) {
+            continue;
+        }
+        const auto& data = *data_opt;
+
+        if (!data.enabled) {
+            continue;
+        }
+
+        if (!context_->check_hit_count(data)) {
+            continue;
+        }
+
+        collect_from_reco(plan, data.name, data.reco_type, data.reco_param);
     }
 
-    if (ctx.first) {
-        ctx.plan.model = param.model;
-        ctx.first = false;
+    // 只有一个节点的组合并了也没有收益
+    std::erase_if(plan.ocr, [](const auto& pair) { return pair.second.size() < 2; });
+    std::erase_if(plan.ocr_rec, [](const auto& pair) { return pair.second.size() < 2; });
+    std::erase_if(plan.nn_classify, [](const auto& pair) { return pair.second.size() < 2; });
+    std::erase_if(plan.nn_detect, [](const auto& pair) { return pair.second.size() < 2; });
+    if (plan.template_match.size() < 2) {
+        plan.template_match.clear();
     }
-    else if (param.model != ctx.plan.model) {
-        LogDebug << "batch OCR skipping node due to model mismatch" << VAR(name) << VAR(param.model) << VAR(ctx.plan.model);
-        return;
+
+    plan.node_names.clear();
+    auto add_names = [&](const auto& entries) {
+        for (const auto& entry : entries) {
+            plan.node_names.emplace(entry.name);
+        }
+    };
+    for (const auto& [model, entries] : plan.ocr) {
+        add_names(entries);
+    }
+    for (const auto& [model, entries] : plan.ocr_rec) {
+        add_names(entries);
     }
+    for (const auto& [model, entries] : plan.nn_classify) {
+        add_names(entries);
+    }
+    for (const auto& [model, entries] : plan.nn_detect) {
+        add_names(entries);
+    }
+    add_names(plan.template_match);
 
-    ctx.plan.node_names.emplace(name);
+    if (plan.node_names.empty()) {
+        LogDebug << "reco plan not needed";
+        return std::nullopt;
+    }
+
+    LogInfo << "prepared reco plan" << VAR(plan.node_names);
+    return plan;
+}
+
+bool PipelineTask::depends_on_plan(const RecoPlan& plan, const MAA_VISION_NS::Target& roi_target) const
+{
+    if (roi_target.type != MAA_VISION_NS::TargetType::PreTask) {
+        return false;
+    }
+    // PreTask 的 ROI 取决于本轮其他节点的结果，规划时还拿不到
+    const auto& ref_name = std::get<std::string>(roi_target.param);
+    return plan.node_names.contains(ref_name);
 }
 
-void PipelineTask::collect_ocr_from_reco(
-    OCRCollectContext& ctx,
+void PipelineTask::collect_from_reco(
+    RecoPlan& plan,
     const std::string& name,
     MAA_RES_NS::Recognition::Type type,
     const MAA_RES_NS::Recognition::Param& param)
 {
     using namespace MAA_RES_NS::Recognition;
+    using namespace MAA_VISION_NS;
+
+    if (plan.node_names.contains(name)) {
+        return;
+    }
+
+    switch (type) {
+    case Type::OCR: {
+        const auto& ocr_param = std::get<OCRerParam>(param);
+        if (depends_on_plan(plan, ocr_param.roi_target)) {
+            LogDebug << "reco plan skipping node with PreTask ROI dependency" << VAR(name);
+            return;
+        }
+        if (!ocr_param.color_filter.empty()) {
+            // color_filter 需要对每个 ROI 单独做颜色二值化，无法与其他节点共享 mask 图
+            return;
+        }
+        auto& group = ocr_param.only_rec ? plan.ocr_rec : plan.ocr;
+        group[ocr_param.model].emplace_back(BatchOCREntry { .name = name, .param = ocr_param });
+        break;
+    }
+
+    case Type::NeuralNetworkClassify: {
+        const auto& nn_param = std::get<NeuralNetworkClassifierParam>(param);
+        if (depends_on_plan(plan, nn_param.roi_target)) {
+            LogDebug << "reco plan skipping node with PreTask ROI dependency" << VAR(name);
+            return;
+        }
+        plan.nn_classify[nn_param.model].emplace_back(BatchNNClassifyEntry { .name = name, .param = nn_param });
+        break;
+    }
+
+    case Type::NeuralNetworkDetect: {
+        const auto& nn_param = std::get<NeuralNetworkDetectorParam>(param);
+        if (depends_on_plan(plan, nn_param.roi_target)) {
+            LogDebug << "reco plan skipping node with PreTask ROI dependency" << VAR(name);
+            return;
+        }
+        plan.nn_detect[nn_param.model].emplace_back(BatchNNDetectEntry { .name = name, .param = nn_param });
+        break;
+    }
 
-    if (type == Type::OCR) {
-        try_add_ocr_node(ctx, name, std::get<MAA_VISION_NS::OCRerParam>(param));
+    case Type::TemplateMatch: {
+        const auto& templ_param = std::get<TemplateMatcherParam>(param);
+        if (depends_on_plan(plan, templ_param.roi_target)) {
+            LogDebug << "reco plan skipping node with PreTask ROI dependency" << VAR(name);
+            return;
+        }
+        if (templ_param.pyramid > 0) {
+            // 金字塔模式只在候选点附近细化，用不上整张得分图
+            return;
+        }
+        plan.template_match.emplace_back(BatchTemplateEntry { .name = name, .param = templ_param });
+        break;
     }
-    else if (type == Type::And) {
+
+    case Type::And: {
         const auto& and_param = std::get<std::shared_ptr<AndParam>>(param);
         if (!and_param) {
             LogError << "Bad AND param" << VAR(name);
             return;
         }
-        collect_ocr_from_sub_recognitions(ctx, and_param->all_of);
+        collect_from_sub_recognitions(plan, and_param->all_of);
+        return;
     }
-    else if (type == Type::Or) {
+
+    case Type::Or: {
         const auto& or_param = std::get<std::shared_ptr<OrParam>>(param);
         if (!or_param) {
             LogError << "Bad OR param" << VAR(name);
             return;
         }
-        collect_ocr_from_sub_recognitions(ctx, or_param->any_of);
+        collect_from_sub_recognitions(plan, or_param->any_of);
+        return;
+    }
+
+    default:
+        return;
     }
+
+    plan.node_names.emplace(name);
 }
 
-void PipelineTask::collect_ocr_from_sub_recognitions(
-    OCRCollectContext& ctx,
-    const std::vector<MAA_RES_NS::Recognition::SubRecognition>& subs)
+void PipelineTask::collect_from_sub_recognitions(RecoPlan& plan, const std::vector<MAA_RES_NS::Recognition::SubRecognition>& subs)
 {
     using namespace MAA_RES_NS::Recognition;
 
@@ -440,11 +794,11 @@ void PipelineTask::collect_ocr_from_sub_recognitions(
                 LogError << "Bad sub ref" << VAR(*node_name);
                 continue;
             }
-            collect_ocr_from_reco(ctx, sub_opt->name, sub_opt->reco_type, sub_opt->reco_param);
+            collect_from_reco(plan, sub_opt->name, sub_opt->reco_type, sub_opt->reco_param);
         }
         else {
             const auto& inline_sub = std::get<InlineSubRecognition>(sub);
-            collect_ocr_from_reco(ctx, inline_sub.sub_name, inline_sub.type, inline_sub.param);
+            collect_from_reco(plan, inline_sub.sub_name, inline_sub.type, inline_sub.param);
         }
     }
 }
@@ -462,6 +816,8 @@ void PipelineTask::save_on_error(const std::string& node_name)
         return;
     }
 
+    refresh_cached_image();
+
     auto image = controller()->cached_image();
     if (image.empty()) {
         LogError << "cached_image is empty";
@@ -474,4 +830,30 @@ void PipelineTask::save_on_error(const std::string& node_name)
     LogInfo << "save on error to" << filepath;
 }
 
+void PipelineTask::refresh_cached_image()
+{
+    if (!cached_image_stale_) {
+        return;
+    }
+
+    LogDebug << "last screencap is partial, take a full one" << VAR(cur_node_);
+    screencap_frame();
+    cached_image_stale_ = false;
+}
+
+bool PipelineTask::action_reads_cached_image(MAA_RES_NS::Action::Type type)
+{
+    using MAA_RES_NS::Action::Type;
+
+    // 其余动作最多只用 cached_image() 的尺寸换算 ROI，区域截图不改尺寸
+    switch (type) {
+    case Type::Command:
+    case Type::Screencap:
+    case Type::Custom:
+        return true;
+    default:
+        return false;
+    }
+}
+
 MAA_TASK_NS_END
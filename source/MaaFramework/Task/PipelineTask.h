@@ -2,11 +2,16 @@
 
 #include "TaskBase.h"
 
+#include <map>
+#include <mutex>
 #include <optional>
 #include <set>
 
 #include "Common/Conf.h"
+#include "Vision/NeuralNetworkClassifier.h"
+#include "Vision/NeuralNetworkDetector.h"
 #include "Vision/OCRer.h"
+#include "Vision/TemplateMatcher.h"
 
 MAA_RES_NS_BEGIN
 struct NodeAttr;
@@ -22,6 +27,69 @@ struct BatchOCREntry
     MEO_TOJSON(name);
 };
 
+struct BatchNNClassifyEntry
+{
+    std::string name;
+    MAA_VISION_NS::NeuralNetworkClassifierParam param;
+
+    MEO_TOJSON(name);
+};
+
+struct BatchNNDetectEntry
+{
+    std::string name;
+    MAA_VISION_NS::NeuralNetworkDetectorParam param;
+
+    MEO_TOJSON(name);
+};
+
+struct BatchTemplateEntry
+{
+    std::string name;
+    MAA_VISION_NS::TemplateMatcherParam param;
+
+    MEO_TOJSON(name);
+};
+
+// 识别开始前对整个 next 列表做的规划，同类识别合并成一次调用
+struct RecoPlan
+{
+    std::map<std::string, std::vector<BatchOCREntry>> ocr;                // model -> det + rec 节点
+    std::map<std::string, std::vector<BatchOCREntry>> ocr_rec;            // model -> only_rec 节点
+    std::map<std::string, std::vector<BatchNNClassifyEntry>> nn_classify; // model -> 节点
+    std::map<std::string, std::vector<BatchNNDetectEntry>> nn_detect;     // model -> 节点
+    std::vector<BatchTemplateEntry> template_match;                       // 同模板且 ROI 重叠的在执行时再合并
+
+    std::set<std::string> node_names;
+};
+
+// 规划的执行结果，各节点识别时优先从这里取
+struct RecoPrefetchCache
+{
+    MAA_VISION_NS::OCRCache ocr;
+    MAA_VISION_NS::ONNXOutputCache nn_classify;
+    MAA_VISION_NS::ONNXOutputCache nn_detect;
+    MAA_VISION_NS::TemplateScoreCache template_score;
+};
+
+// 节点上一次的识别结果。下一帧里它 ROI 覆盖的 tile 都没变时直接复用
+struct RegionRecoEntry
+{
+    std::shared_ptr<const MAA_CTRL_NS::FrameFingerprint> fingerprint = nullptr;
+    std::vector<cv::Rect> rois;
+    RecoResult result;
+    std::vector<cv::Rect> filtered_boxes;
+    cv::Rect best_box { };
+};
+
+struct RegionRecoCache
+{
+    std::shared_ptr<const MAA_CTRL_NS::FrameFingerprint> fingerprint = nullptr; // 当前帧
+
+    std::mutex mutex;
+    std::unordered_map<std::string, RegionRecoEntry> entries;
+};
+
 class PipelineTask : public TaskBase
 {
 public:
@@ -33,33 +101,41 @@ public:
     virtual void post_stop() override;
 
 private:
-    struct BatchOCRPlan
-    {
-        std::string model;
-        std::set<std::string> node_names;
-        std::vector<BatchOCREntry> entries;
-    };
-
-    struct OCRCollectContext
-    {
-        BatchOCRPlan plan;
-        bool first = true;
-    };
-
-private:
-    NodeDetail run_next(const std::vector<MAA_RES_NS::NodeAttr>& next, const PipelineData& pretask);
-    RecoResult recognize_list(const cv::Mat& image, const std::vector<MAA_RES_NS::NodeAttr>& list);
-    std::optional<BatchOCRPlan> prepare_batch_ocr(const std::vector<MAA_RES_NS::NodeAttr>& list);
-
-    void try_add_ocr_node(OCRCollectContext& ctx, const std::string& name, const MAA_VISION_NS::OCRerParam& param);
-    void collect_ocr_from_reco(
-        OCRCollectContext& ctx,
-        const std::string& name,
+    NodeDetail run_next(MAA_RES_NS::CompiledList& next, const PipelineData& pretask);
+    // resolved 与 list 一一对应，由 Context::resolve_list 得到
+    RecoResult
+        recognize_list(const cv::Mat& image, const std::vector<MAA_RES_NS::NodeAttr>& list, const std::vector<PipelineDataPtr>& resolved);
+    bool is_reco_list_deterministic(const std::vector<PipelineDataPtr>& list);
+    std::optional<cv::Rect> reco_list_roi_union(const std::vector<PipelineDataPtr>& list, const cv::Size& image_size);
+    bool merge_reco_roi(
+        cv::Rect& roi_union,
         MAA_RES_NS::Recognition::Type type,
-        const MAA_RES_NS::Recognition::Param& param);
-    void collect_ocr_from_sub_recognitions(OCRCollectContext& ctx, const std::vector<MAA_RES_NS::Recognition::SubRecognition>& subs);
+        const MAA_RES_NS::Recognition::Param& param,
+        const cv::Size& image_size);
+    std::optional<RecoPlan> prepare_reco_plan(const std::vector<PipelineDataPtr>& list);
+
+    std::optional<std::vector<PipelineDataPtr>> collect_parallel_candidates(const std::vector<PipelineDataPtr>& list);
+    bool has_custom_recognition(MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param);
+    RecoResult recognize_parallel(
+        const cv::Mat& image,
+        const std::vector<PipelineDataPtr>& candidates,
+        std::shared_ptr<RecoPrefetchCache> prefetch_cache,
+        std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache);
+
+    bool depends_on_plan(const RecoPlan& plan, const MAA_VISION_NS::Target& roi_target) const;
+    void collect_from_reco(RecoPlan& plan, const std::string& name, MAA_RES_NS::Recognition::Type type, const MAA_RES_NS::Recognition::Param& param);
+    void collect_from_sub_recognitions(RecoPlan& plan, const std::vector<MAA_RES_NS::Recognition::SubRecognition>& subs);
 
     void save_on_error(const std::string& node_name);
+    // 区域截图不更新 cached_image()，需要整图的地方按需补一张
+    void refresh_cached_image();
+    static bool action_reads_cached_image(MAA_RES_NS::Action::Type type);
+
+private:
+    // 每次 run_next 重建，只在同一个 next 列表的循环内复用。列表里有自定义识别时为空
+    std::shared_ptr<RegionRecoCache> region_cache_ = nullptr;
+    // 最近一次截图只截了区域，cached_image() 还是之前的整图
+    bool cached_image_stale_ = false;
 };
 
 MAA_TASK_NS_END
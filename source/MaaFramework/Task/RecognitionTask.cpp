@@ -15,6 +15,15 @@ RecognitionTask::RecognitionTask(const cv::Mat& image, std::string entry, Tasker
 {
 }
 
+RecognitionTask::RecognitionTask(const cv::Mat& image, PipelineDataPtr node, Tasker* tasker, std::shared_ptr<Context> context)
+    : TaskBase(node ? node->name : std::string(), tasker, std::move(context))
+    , image_(image)
+    , node_(std::move(node))
+{
+    // 回调里 get_node_data / override_next 还能按名字找到这个节点
+    context_->push_direct_node(node_);
+}
+
 bool RecognitionTask::run()
 {
     return run_impl() != MaaInvalidId;
@@ -29,7 +38,7 @@ MaaRecoId RecognitionTask::run_impl()
         return MaaInvalidId;
     }
 
-    auto node_opt = context_->get_pipeline_data(entry_);
+    auto node_opt = node_ ? node_ : context_->get_pipeline_data(entry_);
     if (!node_opt) {
         LogError << "get_pipeline_data failed, task not exist" << VAR(entry_);
         return MaaInvalidId;
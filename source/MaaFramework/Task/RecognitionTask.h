@@ -10,6 +10,8 @@ class RecognitionTask : public TaskBase
 {
 public:
     RecognitionTask(const cv::Mat& image, std::string entry, Tasker* tasker, std::shared_ptr<Context> context = nullptr);
+    // 直接使用给定的节点，不再按 entry 在 pipeline 里查找
+    RecognitionTask(const cv::Mat& image, PipelineDataPtr node, Tasker* tasker, std::shared_ptr<Context> context = nullptr);
 
     virtual ~RecognitionTask() override = default;
 
@@ -21,6 +23,7 @@ public:
 
 private:
     cv::Mat image_;
+    PipelineDataPtr node_ = nullptr;
 };
 
 MAA_TASK_NS_END
@@ -52,7 +52,12 @@ MAA_CTRL_NS::ControllerAgent* TaskBase::controller()
     return tasker_ ? tasker_->controller() : nullptr;
 }
 
-RecoResult TaskBase::run_recognition(const cv::Mat& image, const PipelineData& data, std::shared_ptr<MAA_VISION_NS::OCRCache> ocr_cache)
+RecoResult TaskBase::run_recognition(
+    const cv::Mat& image,
+    const PipelineData& data,
+    std::shared_ptr<RecoPrefetchCache> prefetch_cache,
+    std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache,
+    std::shared_ptr<RegionRecoCache> region_cache)
 {
     LogFunc << VAR(cur_node_) << VAR(data.name);
 
@@ -61,9 +66,18 @@ RecoResult TaskBase::run_recognition(const cv::Mat& image, const PipelineData& d
         return { };
     }
 
-    Recognizer recognizer(tasker_, *context_, image, std::move(ocr_cache));
+    Recognizer recognizer(tasker_, *context_, image, std::move(prefetch_cache), std::move(feature_cache), std::move(region_cache));
 
-    json::value cb_detail {
+    notify_recognition_starting(recognizer, data);
+
+    RecoResult result = recognizer.evaluate(data.reco_type, data.reco_param, data.name);
+
+    return finish_recognition(recognizer, std::move(result), data);
+}
+
+void TaskBase::notify_recognition_starting(const Recognizer& recognizer, const PipelineData& data)
+{
+    const json::value cb_detail {
         { "task_id", task_id() },
         { "reco_id", recognizer.get_id() },
         { "name", data.name },
@@ -71,8 +85,18 @@ RecoResult TaskBase::run_recognition(const cv::Mat& image, const PipelineData& d
     };
 
     notify(MaaMsg_Node_Recognition_Starting, cb_detail);
+}
 
-    RecoResult result = recognizer.recognize(data.reco_type, data.reco_param, data.name);
+RecoResult TaskBase::finish_recognition(Recognizer& recognizer, RecoResult result, const PipelineData& data)
+{
+    recognizer.commit(result, data.name);
+
+    json::value cb_detail {
+        { "task_id", task_id() },
+        { "reco_id", recognizer.get_id() },
+        { "name", data.name },
+        { "focus", data.focus },
+    };
 
     if (data.inverse) {
         LogDebug << "pipeline_data.inverse is true, reverse the result" << VAR(data.name) << VAR(result.box);
@@ -153,6 +177,16 @@ cv::Mat TaskBase::screencap()
     return controller()->screencap();
 }
 
+MAA_CTRL_NS::ScreencapFrame TaskBase::screencap_frame(const cv::Rect& roi)
+{
+    if (!controller()) {
+        LogDebug << "controller not bound, skip screencap";
+        return { };
+    }
+
+    return controller()->screencap_frame(roi);
+}
+
 MaaNodeId TaskBase::generate_node_id()
 {
     return ++s_global_node_id;
@@ -12,10 +12,15 @@
 #include "Resource/ResourceMgr.h"
 #include "Tasker/RuntimeCache.h"
 #include "Tasker/Tasker.h"
+#include "Vision/FeatureMatcher.h"
 #include "Vision/OCRer.h"
 
 MAA_TASK_NS_BEGIN
 
+class Recognizer;
+struct RecoPrefetchCache;
+struct RegionRecoCache;
+
 class TaskBase : public NonCopyable
 {
 public:
@@ -38,10 +43,17 @@ protected:
     MAA_RES_NS::ResourceMgr* resource();
     MAA_CTRL_NS::ControllerAgent* controller();
 
-    RecoResult
-        run_recognition(const cv::Mat& image, const PipelineData& data, std::shared_ptr<MAA_VISION_NS::OCRCache> ocr_cache = nullptr);
+    RecoResult run_recognition(
+        const cv::Mat& image,
+        const PipelineData& data,
+        std::shared_ptr<RecoPrefetchCache> prefetch_cache = nullptr,
+        std::shared_ptr<MAA_VISION_NS::FeatureCache> feature_cache = nullptr,
+        std::shared_ptr<RegionRecoCache> region_cache = nullptr);
+    void notify_recognition_starting(const Recognizer& recognizer, const PipelineData& data);
+    RecoResult finish_recognition(Recognizer& recognizer, RecoResult result, const PipelineData& data);
     ActionResult run_action(const RecoResult& reco, const PipelineData& data);
     cv::Mat screencap();
+    MAA_CTRL_NS::ScreencapFrame screencap_frame(const cv::Rect& roi = { });
     MaaNodeId generate_node_id();
     void set_node_detail(MaaNodeId node_id, NodeDetail detail);
     void set_task_detail(TaskDetail detail);
@@ -6,7 +6,6 @@
 #include "Global/PluginMgr.h"
 #include "MaaFramework/MaaMsg.h"
 #include "MaaUtils/Logger.h"
-#include "MaaUtils/Uuid.h"
 #include "Resource/ResourceMgr.h"
 #include "Task/ActionTask.h"
 #include "Task/EmptyTask.h"
@@ -102,13 +101,19 @@ MaaTaskId Tasker::post_recognition(const std::string& reco_type, const json::val
         return MaaInvalidId;
     }
 
-    std::string entry = std::format("recognition/{}/{}", reco_type, make_uuid());
+    if (!resource_) {
+        LogError << "resource not bound";
+        return MaaInvalidId;
+    }
 
-    json::value pipeline_override;
-    pipeline_override[entry]["recognition"] = { { "type", reco_type }, { "param", reco_param } };
+    auto node = resource_->get_direct_recognition_node(reco_type, reco_param);
+    if (!node) {
+        LogError << "failed to get_direct_recognition_node" << VAR(reco_type) << VAR(reco_param);
+        return MaaInvalidId;
+    }
 
-    auto task_ptr = std::make_shared<MAA_TASK_NS::RecognitionTask>(image, entry, this);
-    return post_task(std::move(task_ptr), pipeline_override);
+    auto task_ptr = std::make_shared<MAA_TASK_NS::RecognitionTask>(image, std::move(node), this);
+    return post_task(std::move(task_ptr), json::object { });
 }
 
 MaaTaskId Tasker::post_action(
@@ -123,13 +128,19 @@ MaaTaskId Tasker::post_action(
         return MaaInvalidId;
     }
 
-    std::string entry = std::format("action/{}/{}", action_type, make_uuid());
+    if (!resource_) {
+        LogError << "resource not bound";
+        return MaaInvalidId;
+    }
 
-    json::value pipeline_override;
-    pipeline_override[entry]["action"] = { { "type", action_type }, { "param", action_param } };
+    auto node = resource_->get_direct_action_node(action_type, action_param);
+    if (!node) {
+        LogError << "failed to get_direct_action_node" << VAR(action_type) << VAR(action_param);
+        return MaaInvalidId;
+    }
 
-    auto task_ptr = std::make_shared<MAA_TASK_NS::ActionTask>(box, reco_detail, entry, this);
-    return post_task(std::move(task_ptr), pipeline_override);
+    auto task_ptr = std::make_shared<MAA_TASK_NS::ActionTask>(box, reco_detail, std::move(node), this);
+    return post_task(std::move(task_ptr), json::object { });
 }
 
 MaaStatus Tasker::status(MaaTaskId task_id) const
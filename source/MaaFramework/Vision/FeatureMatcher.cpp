@@ -19,11 +19,13 @@ FeatureMatcher::FeatureMatcher(
     cv::Mat image,
     std::vector<cv::Rect> rois,
     FeatureMatcherParam param,
-    std::vector<cv::Mat> templates,
-    std::string name)
+    std::vector<PreparedTemplatePtr> templates,
+    std::string name,
+    std::shared_ptr<FeatureCache> scene_cache)
     : VisionBase(std::move(image), std::move(rois), std::move(name))
     , param_(std::move(param))
     , templates_(std::move(templates))
+    , scene_cache_(std::move(scene_cache))
 {
     analyze();
 }
@@ -37,11 +39,18 @@ void FeatureMatcher::analyze()
 
     auto start_time = std::chrono::steady_clock::now();
 
-    for (const auto& templ : templates_) {
-        auto [keypoints_1, descriptors_1] = detect(templ, create_mask(templ, param_.green_mask));
+    // 截图的特征点与模板无关，每个 ROI 只算一次
+    std::vector<FeatureSet> scene_features_list;
+    while (next_roi()) {
+        scene_features_list.emplace_back(scene_features());
+    }
+    reset_roi();
+
+    for (const auto& prepared : templates_) {
+        const FeatureSet& templ_features = template_features(*prepared);
 
-        while (next_roi()) {
-            auto results = feature_match(templ, keypoints_1, descriptors_1);
+        for (size_t roi_index = 0; next_roi(); ++roi_index) {
+            auto results = feature_match(prepared->image, templ_features, scene_features_list.at(roi_index));
             add_results(std::move(results), param_.count);
         }
         reset_roi();
@@ -55,9 +64,10 @@ void FeatureMatcher::analyze()
 }
 
 FeatureMatcher::ResultsVec
-    FeatureMatcher::feature_match(const cv::Mat& templ, const std::vector<cv::KeyPoint>& keypoints_1, const cv::Mat& descriptors_1) const
+    FeatureMatcher::feature_match(const cv::Mat& templ, const FeatureSet& templ_features, const FeatureSet& scene_features) const
 {
-    auto [keypoints_2, descriptors_2] = detect(image_, create_mask(image_, roi_));
+    const auto& [keypoints_1, descriptors_1] = templ_features;
+    const auto& [keypoints_2, descriptors_2] = scene_features;
 
     auto match_points = match(descriptors_1, descriptors_2);
 
@@ -72,6 +82,41 @@ FeatureMatcher::ResultsVec
     return results;
 }
 
+const FeatureSet& FeatureMatcher::template_features(const PreparedTemplate& prepared) const
+{
+    // 同一模板并发时只算一次，另一个线程等着直接拿结果
+    std::unique_lock lock(prepared.features_mutex);
+
+    PreparedTemplate::FeatureKey key { param_.detector, param_.green_mask };
+    if (auto it = prepared.features.find(key); it != prepared.features.end()) {
+        return it->second;
+    }
+
+    // 各 detector 内部都会先转灰度，直接用预处理好的灰度图，省一次转换
+    auto [keypoints, descriptors] = detect(prepared.gray, param_.green_mask ? prepared.green_mask : prepared.mask);
+    return prepared.features.emplace(key, FeatureSet { .keypoints = std::move(keypoints), .descriptors = std::move(descriptors) })
+        .first->second;
+}
+
+FeatureSet FeatureMatcher::scene_features() const
+{
+    FeatureCache::Key key { param_.detector, roi_ };
+    if (scene_cache_) {
+        if (auto cached = scene_cache_->get(key)) {
+            LogDebug << name_ << "scene features from cache" << VAR(roi_);
+            return std::move(*cached);
+        }
+    }
+
+    auto [keypoints, descriptors] = detect(image_, create_mask(image_, roi_));
+    FeatureSet features { .keypoints = std::move(keypoints), .descriptors = std::move(descriptors) };
+
+    if (scene_cache_) {
+        scene_cache_->set(key, features);
+    }
+    return features;
+}
+
 cv::Ptr<cv::Feature2D> FeatureMatcher::create_detector() const
 {
     switch (param_.detector) {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <vector>
 
@@ -23,6 +26,41 @@ struct FeatureMatcherResult
     MEO_JSONIZATION(box, count);
 };
 
+// 同一帧截图的特征点，按 (detector, ROI) 缓存，供同一帧内的多个节点共用
+class FeatureCache
+{
+public:
+    using Key = std::pair<FeatureMatcherParam::Detector, cv::Rect>;
+
+    std::optional<FeatureSet> get(const Key& key) const
+    {
+        std::unique_lock lock(mutex_);
+        auto it = cache_.find(key);
+        return it == cache_.end() ? std::nullopt : std::make_optional(it->second);
+    }
+
+    void set(const Key& key, FeatureSet features)
+    {
+        std::unique_lock lock(mutex_);
+        cache_.insert_or_assign(key, std::move(features));
+    }
+
+private:
+    struct KeyComparator
+    {
+        bool operator()(const Key& lhs, const Key& rhs) const
+        {
+            if (lhs.first != rhs.first) {
+                return lhs.first < rhs.first;
+            }
+            return RectComparator { }(lhs.second, rhs.second);
+        }
+    };
+
+    mutable std::mutex mutex_;
+    std::map<Key, FeatureSet, KeyComparator> cache_;
+};
+
 class FeatureMatcher
     : public VisionBase
     , public RecoResultAPI<FeatureMatcherResult>
@@ -32,12 +70,16 @@ public:
         cv::Mat image,
         std::vector<cv::Rect> rois,
         FeatureMatcherParam param,
-        std::vector<cv::Mat> templates,
-        std::string name = "");
+        std::vector<PreparedTemplatePtr> templates,
+        std::string name = "",
+        std::shared_ptr<FeatureCache> scene_cache = nullptr);
 
 private:
     void analyze();
-    ResultsVec feature_match(const cv::Mat& templ, const std::vector<cv::KeyPoint>& keypoints_1, const cv::Mat& descriptors_1) const;
+    ResultsVec feature_match(const cv::Mat& templ, const FeatureSet& templ_features, const FeatureSet& scene_features) const;
+
+    const FeatureSet& template_features(const PreparedTemplate& prepared) const;
+    FeatureSet scene_features() const;
 
     void add_results(ResultsVec results, int count);
     void cherry_pick();
@@ -68,7 +110,8 @@ private:
 
 private:
     const FeatureMatcherParam param_;
-    const std::vector<cv::Mat> templates_;
+    const std::vector<PreparedTemplatePtr> templates_;
+    const std::shared_ptr<FeatureCache> scene_cache_;
 };
 
 MAA_VISION_NS_END
@@ -1,7 +1,5 @@
 #include "NeuralNetworkClassifier.h"
 
-#include <onnxruntime/onnxruntime_cxx_api.h>
-
 #include "MaaUtils/NoWarningCV.hpp"
 #include "VisionUtils.hpp"
 #include <ranges>
@@ -12,13 +10,15 @@ NeuralNetworkClassifier::NeuralNetworkClassifier(
     cv::Mat image,
     std::vector<cv::Rect> rois,
     NeuralNetworkClassifierParam param,
-    std::shared_ptr<Ort::Session> session,
+    ONNXSessionPtr session,
     const Ort::MemoryInfo& memory_info,
-    std::string name)
+    std::string name,
+    std::shared_ptr<const ONNXOutputCache> cache)
     : VisionBase(std::move(image), std::move(rois), std::move(name))
     , param_(std::move(param))
     , session_(std::move(session))
     , memory_info_(memory_info)
+    , cache_(std::move(cache))
 {
     analyze();
 }
@@ -33,8 +33,17 @@ void NeuralNetworkClassifier::analyze()
     }
     auto start_time = std::chrono::steady_clock::now();
 
+    std::vector<cv::Rect> rois;
     while (next_roi()) {
-        auto res = classify();
+        rois.emplace_back(roi_);
+    }
+    reset_roi();
+
+    // 规划阶段已经批量推理过的 ROI 直接取缓存，其余 ROI 合成一个 batch 推理
+    auto outputs = infer_rois_with_cache(*session_, memory_info_, image_, rois, cache_.get(), param_.model);
+
+    for (size_t index = 0; next_roi(); ++index) {
+        auto res = classify(std::move(outputs.at(index).data));
         add_results({ std::move(res) }, param_.expected);
     }
 
@@ -45,41 +54,11 @@ void NeuralNetworkClassifier::analyze()
              << VAR(param_.labels) << VAR(param_.expected);
 }
 
-NeuralNetworkClassifier::Result NeuralNetworkClassifier::classify() const
+NeuralNetworkClassifier::Result NeuralNetworkClassifier::classify(std::vector<float> output) const
 {
-    if (!session_) {
-        LogError << "OrtSession not loaded";
+    if (output.empty()) {
         return { };
     }
-    // batch_size, channel, height, width
-    // for yolov8, input_shape is { 1, 3, 640, 640 }
-    const auto input_shape = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
-    if (input_shape.size() != 4) {
-        LogError << "Input shape is not 4" << VAR(input_shape);
-        return { };
-    }
-
-    cv::Mat image = image_with_roi();
-    cv::Size raw_roi_size(image.cols, image.rows);
-    cv::Size input_image_size(static_cast<int>(input_shape[3]), static_cast<int>(input_shape[2]));
-    cv::resize(image, image, input_image_size, 0, 0, cv::INTER_AREA);
-    std::vector<float> input = image_to_tensor(image);
-
-    Ort::Value input_tensor =
-        Ort::Value::CreateTensor<float>(memory_info_, input.data(), input.size(), input_shape.data(), input_shape.size());
-
-    Ort::AllocatorWithDefaultOptions allocator;
-    const std::string in_0 = session_->GetInputNameAllocated(0, allocator).get();
-    const std::string out_0 = session_->GetOutputNameAllocated(0, allocator).get();
-    const std::vector input_names { in_0.c_str() };
-    const std::vector output_names { out_0.c_str() };
-
-    Ort::RunOptions run_options;
-    auto output_tensor =
-        session_->Run(run_options, input_names.data(), &input_tensor, input_names.size(), output_names.data(), output_names.size());
-
-    const float* raw_output = output_tensor[0].GetTensorData<float>();
-    std::vector<float> output(raw_output, raw_output + output_tensor[0].GetTensorTypeAndShapeInfo().GetElementCount());
 
     Result res;
     res.raw = std::move(output);
@@ -129,7 +108,8 @@ cv::Mat NeuralNetworkClassifier::draw_result(const Result& res) const
 
     for (size_t i = 0; i != res.raw.size(); ++i) {
         const auto color = i == res.cls_index ? cv::Scalar(0, 0, 255) : cv::Scalar(255, 0, 0);
-        std::string text = std::format("{} {}: prob {:.3f}, raw {:.3f}", i, param_.labels[i], res.probs[i], res.raw[i]);
+        const std::string label = i < param_.labels.size() ? param_.labels[i] : std::format("Unknown_{}", i);
+        std::string text = std::format("{} {}: prob {:.3f}, raw {:.3f}", i, label, res.probs[i], res.raw[i]);
         cv::putText(image_draw, text, pt, cv::FONT_HERSHEY_PLAIN, 1.2, color, 1);
         pt.y += 20;
     }
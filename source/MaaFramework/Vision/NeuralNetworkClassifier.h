@@ -3,9 +3,8 @@
 #include <ostream>
 #include <vector>
 
-#include <onnxruntime/onnxruntime_cxx_api.h>
-
 #include "MaaUtils/JsonExt.hpp"
+#include "ONNXSession.hpp"
 #include "VisionBase.h"
 #include "VisionTypes.h"
 
@@ -34,14 +33,15 @@ public:
         cv::Mat image,
         std::vector<cv::Rect> rois,
         NeuralNetworkClassifierParam param,
-        std::shared_ptr<Ort::Session> session,
+        ONNXSessionPtr session,
         const Ort::MemoryInfo& memory_info,
-        std::string name = "");
+        std::string name = "",
+        std::shared_ptr<const ONNXOutputCache> cache = nullptr);
 
 private:
     void analyze();
 
-    Result classify() const;
+    Result classify(std::vector<float> output) const;
 
     void add_results(ResultsVec results, const std::vector<int>& expected);
     void cherry_pick();
@@ -52,8 +52,9 @@ private:
 
 private:
     const NeuralNetworkClassifierParam param_;
-    std::shared_ptr<Ort::Session> session_ = nullptr;
+    ONNXSessionPtr session_ = nullptr;
     const Ort::MemoryInfo& memory_info_;
+    std::shared_ptr<const ONNXOutputCache> cache_ = nullptr;
 };
 
 MAA_VISION_NS_END
@@ -8,8 +8,6 @@
 
 #include <boost/regex.hpp>
 
-#include <onnxruntime/onnxruntime_cxx_api.h>
-
 #include "MaaUtils/NoWarningCV.hpp"
 #include "VisionUtils.hpp"
 
@@ -19,13 +17,15 @@ NeuralNetworkDetector::NeuralNetworkDetector(
     cv::Mat image,
     std::vector<cv::Rect> rois,
     NeuralNetworkDetectorParam param,
-    std::shared_ptr<Ort::Session> session,
+    ONNXSessionPtr session,
     const Ort::MemoryInfo& memory_info,
-    std::string name)
+    std::string name,
+    std::shared_ptr<const ONNXOutputCache> cache)
     : VisionBase(std::move(image), std::move(rois), std::move(name))
     , param_(std::move(param))
     , session_(std::move(session))
     , memory_info_(memory_info)
+    , cache_(std::move(cache))
 {
     analyze();
 }
@@ -42,8 +42,18 @@ void NeuralNetworkDetector::analyze()
     auto start_time = std::chrono::steady_clock::now();
 
     auto labels = param_.labels.empty() ? parse_labels_from_metadata() : param_.labels;
+
+    std::vector<cv::Rect> rois;
     while (next_roi()) {
-        auto results = detect(labels);
+        rois.emplace_back(roi_);
+    }
+    reset_roi();
+
+    // 规划阶段已经批量推理过的 ROI 直接取缓存，其余 ROI 合成一个 batch 推理
+    auto outputs = infer_rois_with_cache(*session_, memory_info_, image_, rois, cache_.get(), param_.model);
+
+    for (size_t index = 0; next_roi(); ++index) {
+        auto results = detect(outputs.at(index), labels);
         add_results(std::move(results), param_.expected, param_.thresholds);
     }
 
@@ -54,43 +64,15 @@ void NeuralNetworkDetector::analyze()
              << VAR(param_.expected) << VAR(param_.thresholds);
 }
 
-NeuralNetworkDetector::ResultsVec NeuralNetworkDetector::detect(const std::vector<std::string>& labels) const
+NeuralNetworkDetector::ResultsVec NeuralNetworkDetector::detect(const ONNXOutput& output, const std::vector<std::string>& labels) const
 {
-    if (!session_) {
-        LogError << "OrtSession not loaded";
-        return { };
-    }
-
-    // batch_size, channel, height, width
-    // for yolov8, input_shape is { 1, 3, 640, 640 }
-    const auto input_shape = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
-    if (input_shape.size() != 4) {
-        LogError << "Input shape is not 4" << VAR(input_shape);
+    // output_shape is { 5, 8400 }（已去掉 batch 维）
+    const auto& output_shape = output.shape;
+    if (output.data.empty() || output_shape.size() != 2) {
+        LogError << name_ << "Unexpected output shape" << VAR(output_shape);
         return { };
     }
-
-    cv::Mat image = image_with_roi();
-    cv::Size raw_roi_size(image.cols, image.rows);
-    cv::Size input_image_size(static_cast<int>(input_shape[3]), static_cast<int>(input_shape[2]));
-    cv::resize(image, image, input_image_size, 0, 0, cv::INTER_AREA);
-    std::vector<float> input = image_to_tensor(image);
-
-    Ort::Value input_tensor =
-        Ort::Value::CreateTensor<float>(memory_info_, input.data(), input.size(), input_shape.data(), input_shape.size());
-
-    Ort::AllocatorWithDefaultOptions allocator;
-    const std::string in_0 = session_->GetInputNameAllocated(0, allocator).get();
-    const std::string out_0 = session_->GetOutputNameAllocated(0, allocator).get();
-    const std::vector input_names { in_0.c_str() };
-    const std::vector output_names { out_0.c_str() };
-
-    Ort::RunOptions run_options;
-    auto output_tensor =
-        session_->Run(run_options, input_names.data(), &input_tensor, input_names.size(), output_names.data(), output_names.size());
-
-    const float* raw_output = output_tensor[0].GetTensorData<float>();
-    // output_shape is { 1, 5, 8400 }
-    std::vector<int64_t> output_shape = output_tensor[0].GetTensorTypeAndShapeInfo().GetShape();
+    const float* raw_output = output.data.data();
 
     // yolov8 的 onnx 输出和前面的 v5, v7 等似乎不太一样，目前网上 yolov8 的 demo 较少，文档也没找到
     // 这里的输出解析是我跟着数据推测的：
@@ -102,29 +84,30 @@ NeuralNetworkDetector::ResultsVec NeuralNetworkDetector::detect(const std::vecto
     // cls2: conf0, conf1, ..... conf8399
     // cls3: conf0, conf1, ..... conf8399
     // ......
-    std::vector<std::vector<float>> output(output_shape[1]);
-    for (int64_t i = 0; i < output_shape[1]; i++) {
-        output[i] = std::vector<float>(raw_output + i * output_shape[2], raw_output + (i + 1) * output_shape[2]);
+    std::vector<std::vector<float>> rows(output_shape[0]);
+    for (int64_t i = 0; i < output_shape[0]; i++) {
+        rows[i] = std::vector<float>(raw_output + i * output_shape[1], raw_output + (i + 1) * output_shape[1]);
     }
 
     ResultsVec raw_results;
-    const size_t output_size = output.back().size();
-    double width_ratio = 1.0 * raw_roi_size.width / input_image_size.width;
-    double height_ratio = 1.0 * raw_roi_size.height / input_image_size.height;
+    const size_t output_size = rows.back().size();
+    const cv::Size input_image_size = session_->input_size();
+    double width_ratio = 1.0 * roi_.width / input_image_size.width;
+    double height_ratio = 1.0 * roi_.height / input_image_size.height;
 
     for (size_t i = 0; i < output_size; ++i) {
         constexpr size_t kConfidenceIndex = 4;
-        for (size_t j = kConfidenceIndex; j < output.size(); ++j) {
-            float score = output[j][i];
+        for (size_t j = kConfidenceIndex; j < rows.size(); ++j) {
+            float score = rows[j][i];
             constexpr float kThreshold = 0.3f;
             if (score < kThreshold) {
                 continue;
             }
 
-            int center_x = static_cast<int>(output[0][i]);
-            int center_y = static_cast<int>(output[1][i]);
-            int w = static_cast<int>(output[2][i]);
-            int h = static_cast<int>(output[3][i]);
+            int center_x = static_cast<int>(rows[0][i]);
+            int center_y = static_cast<int>(rows[1][i]);
+            int w = static_cast<int>(rows[2][i]);
+            int h = static_cast<int>(rows[3][i]);
 
             int x = center_x - w / 2;
             int y = center_y - h / 2;
@@ -257,7 +240,7 @@ std::vector<std::string> NeuralNetworkDetector::parse_labels_from_metadata() con
     }
 
     Ort::AllocatorWithDefaultOptions allocator;
-    Ort::ModelMetadata metadata = session_->GetModelMetadata();
+    Ort::ModelMetadata metadata = session_->session->GetModelMetadata();
 
     std::string names_str;
 
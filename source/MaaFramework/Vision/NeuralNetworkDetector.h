@@ -4,11 +4,10 @@
 #include <vector>
 
 #include "MaaUtils/JsonExt.hpp"
+#include "ONNXSession.hpp"
 #include "VisionBase.h"
 #include "VisionTypes.h"
 
-#include <onnxruntime/onnxruntime_cxx_api.h>
-
 #include "Common/Conf.h"
 
 MAA_VISION_NS_BEGIN
@@ -32,14 +31,15 @@ public:
         cv::Mat image,
         std::vector<cv::Rect> rois,
         NeuralNetworkDetectorParam param,
-        std::shared_ptr<Ort::Session> session,
+        ONNXSessionPtr session,
         const Ort::MemoryInfo& memory_info,
-        std::string name = "");
+        std::string name = "",
+        std::shared_ptr<const ONNXOutputCache> cache = nullptr);
 
 private:
     void analyze();
 
-    ResultsVec detect(const std::vector<std::string>& labels) const;
+    ResultsVec detect(const ONNXOutput& output, const std::vector<std::string>& labels) const;
 
     void add_results(ResultsVec results, const std::vector<int>& expected, const std::vector<double>& thresholds);
     void cherry_pick();
@@ -53,8 +53,9 @@ private:
 
 private:
     const NeuralNetworkDetectorParam param_;
-    std::shared_ptr<Ort::Session> session_ = nullptr;
+    ONNXSessionPtr session_ = nullptr;
     const Ort::MemoryInfo& memory_info_;
+    std::shared_ptr<const ONNXOutputCache> cache_ = nullptr;
 };
 
 MAA_VISION_NS_END
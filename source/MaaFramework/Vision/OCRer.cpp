@@ -73,8 +73,10 @@ void OCRer::analyze()
 {
     auto start_time = std::chrono::steady_clock::now();
 
-    while (next_roi()) {
-        auto results = cache_ ? handle_cached() : predict();
+    auto batch_rec = predict_all_only_rec();
+
+    for (size_t index = 0; next_roi(); ++index) {
+        auto results = cache_ ? handle_cached() : batch_rec ? ResultsVec { batch_rec->at(index) } : predict();
 
         if (debug_draw_) {
             auto draw = draw_result(results);
@@ -128,6 +130,32 @@ OCRer::ResultsVec OCRer::predict() const
     return results;
 }
 
+std::optional<OCRer::ResultsVec> OCRer::predict_all_only_rec()
+{
+    if (cache_ || !param_.only_rec || color_filter_) {
+        return std::nullopt;
+    }
+
+    std::vector<cv::Rect> rois;
+    while (next_roi()) {
+        rois.emplace_back(roi_);
+    }
+    reset_roi();
+
+    if (rois.size() < 2) {
+        return std::nullopt;
+    }
+
+    // 多个 ROI 时合成一次 BatchPredict。Recognizer::BatchPredict 不传 indices 时输出顺序与输入一致
+    // （会重排顺序的是 PPOCR 整条流水线里的 det 结果）
+    auto results = predict_batch_rec(rois);
+    if (results.size() != rois.size()) {
+        LogWarn << "batch rec failed, fallback to one by one" << VAR(rois.size()) << VAR(results.size());
+        return std::nullopt;
+    }
+    return results;
+}
+
 OCRer::ResultsVec OCRer::handle_cached() const
 {
     if (!cache_) {
@@ -175,11 +203,7 @@ OCRer::ResultsVec OCRer::predict_det_and_rec(const cv::Mat& image_roi) const
 
     fastdeploy::vision::OCRResult ocr_result;
 
-    bool ret = false;
-    {
-        std::unique_lock lock(s_predict_mutex_);
-        ret = ocrer_->Predict(image_roi, &ocr_result);
-    }
+    bool ret = ocrer_->Predict(image_roi, &ocr_result);
     if (!ret) {
         LogWarn << "predict return false" << VAR(ocrer_) << VAR(image_) << VAR(image_roi);
         return { };
@@ -231,11 +255,7 @@ OCRer::Result OCRer::predict_only_rec(const cv::Mat& image_roi) const
 
     std::string reco_text;
     float reco_score = 0;
-    bool ret = false;
-    {
-        std::unique_lock lock(s_predict_mutex_);
-        ret = recer_->Predict(image_roi, &reco_text, &reco_score);
-    }
+    bool ret = recer_->Predict(image_roi, &reco_text, &reco_score);
     if (!ret) {
         LogWarn << "recer_ return false" << VAR(recer_) << VAR(image_) << VAR(image_roi);
         return { };
@@ -267,11 +287,7 @@ OCRer::ResultsVec OCRer::predict_batch_rec(const std::vector<cv::Rect>& rois) co
 
     fastdeploy::vision::OCRResult ocr_result;
 
-    bool ret = false;
-    {
-        std::unique_lock lock(s_predict_mutex_);
-        ret = recer_->BatchPredict(imgs, &ocr_result);
-    }
+    bool ret = recer_->BatchPredict(imgs, &ocr_result);
     if (!ret) {
         LogWarn << "recer_ BatchPredict return false" << VAR(recer_) << VAR(rois) << VAR(imgs);
         return { };
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <mutex>
 #include <ostream>
 #include <unordered_map>
 #include <vector>
@@ -72,6 +71,7 @@ private:
     void analyze();
 
     ResultsVec predict() const;
+    std::optional<ResultsVec> predict_all_only_rec();
     ResultsVec handle_cached() const;
 
     void add_results(ResultsVec results, const std::vector<std::wstring>& expected);
@@ -102,8 +102,6 @@ private:
     std::shared_ptr<fastdeploy::vision::ocr::DBDetector> deter_ = nullptr;
     std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer_ = nullptr;
     std::shared_ptr<fastdeploy::pipeline::PPOCRv4> ocrer_ = nullptr;
-
-    inline static std::mutex s_predict_mutex_;
 };
 
 using OCRCache = std::unordered_map<std::string, OCRer::ResultsVec>;
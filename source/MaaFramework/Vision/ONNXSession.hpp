@@ -0,0 +1,209 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <onnxruntime/onnxruntime_cxx_api.h>
+
+#include "Common/Conf.h"
+#include "MaaUtils/Logger.h"
+#include "MaaUtils/NoWarningCV.hpp"
+#include "VisionTypes.h"
+#include "VisionUtils.hpp"
+
+MAA_VISION_NS_BEGIN
+
+// 加载时就把输入输出的名字和形状查好，推理时不用每次再问 session
+struct ONNXSession
+{
+    std::shared_ptr<Ort::Session> session = nullptr;
+    std::string input_name;
+    std::string output_name;
+    std::vector<int64_t> input_shape; // batch_size, channel, height, width。batch 维为 -1 表示支持动态 batch
+
+    bool dynamic_batch() const { return input_shape.size() == 4 && input_shape[0] < 0; }
+
+    cv::Size input_size() const
+    {
+        return input_shape.size() == 4 ? cv::Size(static_cast<int>(input_shape[3]), static_cast<int>(input_shape[2])) : cv::Size();
+    }
+
+    // 输入张量的缓冲区用完归还，同一模型下次推理直接复用，不再每次重新分配
+    // session 会被多个线程同时使用，所以是个小池子而不是单个 buffer
+    std::vector<float> acquire_buffer(size_t size) const
+    {
+        std::vector<float> buffer;
+        {
+            std::unique_lock lock(buffers_mutex);
+            if (!free_buffers.empty()) {
+                buffer = std::move(free_buffers.back());
+                free_buffers.pop_back();
+            }
+        }
+        buffer.resize(size);
+        return buffer;
+    }
+
+    void give_back_buffer(std::vector<float> buffer) const
+    {
+        std::unique_lock lock(buffers_mutex);
+        free_buffers.emplace_back(std::move(buffer));
+    }
+
+    mutable std::mutex buffers_mutex;
+    mutable std::vector<std::vector<float>> free_buffers;
+};
+
+using ONNXSessionPtr = std::shared_ptr<const ONNXSession>;
+
+// 单个样本的输出，shape 不含 batch 维
+struct ONNXOutput
+{
+    std::vector<int64_t> shape;
+    std::vector<float> data;
+};
+
+// 同一帧内按 model -> ROI 缓存的模型输出
+using ONNXOutputCache = std::unordered_map<std::string, std::map<cv::Rect, ONNXOutput, RectComparator>>;
+
+inline ONNXSessionPtr make_onnx_session(Ort::Session raw_session)
+{
+    auto result = std::make_shared<ONNXSession>();
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    result->input_name = raw_session.GetInputNameAllocated(0, allocator).get();
+    result->output_name = raw_session.GetOutputNameAllocated(0, allocator).get();
+    result->input_shape = raw_session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    result->session = std::make_shared<Ort::Session>(std::move(raw_session));
+
+    LogDebug << VAR(result->input_name) << VAR(result->output_name) << VAR(result->input_shape);
+    return result;
+}
+
+// 把各 ROI 缩放到模型输入尺寸后拼成一个 NCHW 张量推理，模型 batch 维固定时退化为逐个推理
+// 返回值与 rois 一一对应，失败时返回空
+inline std::vector<ONNXOutput>
+    infer_rois(const ONNXSession& session, const Ort::MemoryInfo& memory_info, const cv::Mat& image, const std::vector<cv::Rect>& rois)
+{
+    if (!session.session) {
+        LogError << "OrtSession not loaded";
+        return { };
+    }
+
+    const cv::Size input_size = session.input_size();
+    if (input_size.width <= 0 || input_size.height <= 0) {
+        LogError << "Unsupported input shape" << VAR(session.input_shape);
+        return { };
+    }
+
+    const size_t count = rois.size();
+    const size_t batch = session.dynamic_batch() ? count : 1;
+    const size_t sample_size = 3ULL * input_size.width * input_size.height;
+    const char* input_name = session.input_name.c_str();
+    const char* output_name = session.output_name.c_str();
+
+    if (session.input_shape[1] != 3) {
+        LogError << "Unsupported channel count" << VAR(session.input_shape);
+        return { };
+    }
+
+    std::vector<ONNXOutput> outputs;
+    outputs.reserve(count);
+
+    std::vector<float> input = session.acquire_buffer(batch * sample_size);
+    cv::Mat resized;
+
+    for (size_t begin = 0; begin < count; begin += batch) {
+        const size_t n = std::min(batch, count - begin);
+
+        // 缩放结果复用同一块 Mat，之后一次遍历直接写进输入张量
+        for (size_t i = 0; i != n; ++i) {
+            cv::resize(image(rois.at(begin + i)), resized, input_size, 0, 0, cv::INTER_AREA);
+            if (!bgr_to_chw_tensor(resized, input.data() + i * sample_size)) {
+                session.give_back_buffer(std::move(input));
+                return { };
+            }
+        }
+
+        std::vector<int64_t> input_shape = session.input_shape;
+        input_shape[0] = static_cast<int64_t>(n);
+        Ort::Value input_tensor =
+            Ort::Value::CreateTensor<float>(memory_info, input.data(), n * sample_size, input_shape.data(), input_shape.size());
+
+        Ort::RunOptions run_options;
+        auto output_tensor = session.session->Run(run_options, &input_name, &input_tensor, 1, &output_name, 1);
+
+        const float* raw_output = output_tensor[0].GetTensorData<float>();
+        std::vector<int64_t> output_shape = output_tensor[0].GetTensorTypeAndShapeInfo().GetShape();
+        const size_t element_count = output_tensor[0].GetTensorTypeAndShapeInfo().GetElementCount();
+        if (output_shape.empty() || output_shape.front() != static_cast<int64_t>(n)) {
+            LogError << "Unexpected output shape" << VAR(output_shape) << VAR(n);
+            session.give_back_buffer(std::move(input));
+            return { };
+        }
+
+        const size_t per_sample = element_count / n;
+        std::vector<int64_t> sample_shape(output_shape.begin() + 1, output_shape.end());
+        for (size_t i = 0; i != n; ++i) {
+            outputs.emplace_back(
+                ONNXOutput {
+                    .shape = sample_shape,
+                    .data = std::vector<float>(raw_output + i * per_sample, raw_output + (i + 1) * per_sample),
+                });
+        }
+    }
+
+    session.give_back_buffer(std::move(input));
+    return outputs;
+}
+
+// 先从 cache 里取，取不到的 ROI 再合成一批推理。返回值与 rois 一一对应，推理失败的 ROI 对应空输出
+inline std::vector<ONNXOutput> infer_rois_with_cache(
+    const ONNXSession& session,
+    const Ort::MemoryInfo& memory_info,
+    const cv::Mat& image,
+    const std::vector<cv::Rect>& rois,
+    const ONNXOutputCache* cache,
+    const std::string& model)
+{
+    std::vector<ONNXOutput> outputs(rois.size());
+
+    const std::map<cv::Rect, ONNXOutput, RectComparator>* model_cache = nullptr;
+    if (cache) {
+        if (auto iter = cache->find(model); iter != cache->end()) {
+            model_cache = &iter->second;
+        }
+    }
+
+    std::vector<size_t> missing_indices;
+    std::vector<cv::Rect> missing_rois;
+    for (size_t i = 0; i != rois.size(); ++i) {
+        if (model_cache) {
+            if (auto iter = model_cache->find(rois[i]); iter != model_cache->end()) {
+                outputs[i] = iter->second;
+                continue;
+            }
+        }
+        missing_indices.emplace_back(i);
+        missing_rois.emplace_back(rois[i]);
+    }
+
+    if (missing_rois.empty()) {
+        return outputs;
+    }
+
+    auto inferred = infer_rois(session, memory_info, image, missing_rois);
+    if (inferred.size() != missing_rois.size()) {
+        return outputs;
+    }
+    for (size_t i = 0; i != missing_indices.size(); ++i) {
+        outputs[missing_indices[i]] = std::move(inferred[i]);
+    }
+    return outputs;
+}
+
+MAA_VISION_NS_END
@@ -1,5 +1,13 @@
 #include "TemplateMatcher.h"
 
+#include <algorithm>
+#include <map>
+#include <optional>
+
+MAA_SUPPRESS_CV_WARNINGS_BEGIN
+#include <opencv2/core/hal/intrin.hpp>
+MAA_SUPPRESS_CV_WARNINGS_END
+
 #include "MaaUtils/Logger.h"
 #include "MaaUtils/NoWarningCV.hpp"
 #include "MaaUtils/StringMisc.hpp"
@@ -7,20 +15,65 @@
 
 MAA_VISION_NS_BEGIN
 
+void TemplateScoreCache::set(PreparedTemplatePtr templ, int method, bool green_mask, const cv::Rect& area, cv::Mat score)
+{
+    scores_[{ std::move(templ), method, green_mask }].emplace_back(area, std::move(score));
+}
+
+std::optional<cv::Mat> TemplateScoreCache::get(const PreparedTemplatePtr& templ, int method, bool green_mask, const cv::Rect& roi) const
+{
+    auto iter = scores_.find({ templ, method, green_mask });
+    if (iter == scores_.end()) {
+        return std::nullopt;
+    }
+
+    const cv::Size templ_size = templ->image.size();
+    for (const auto& [area, score] : iter->second) {
+        if ((area & roi) != roi) {
+            continue;
+        }
+        // 得分图上 (x, y) 只取决于以它为左上角、模板大小的窗口，裁出来和单独对 roi 匹配在数学上相同
+        // 但 OpenCV 对较大的模板用 DFT 算相关，浮点误差与参与计算的图大小有关，分数只在误差范围内一致，不保证逐位相同
+        cv::Rect crop(roi.x - area.x, roi.y - area.y, roi.width - templ_size.width + 1, roi.height - templ_size.height + 1);
+        return score(crop);
+    }
+    return std::nullopt;
+}
+
 TemplateMatcher::TemplateMatcher(
     cv::Mat image,
     std::vector<cv::Rect> rois,
     TemplateMatcherParam param,
-    std::vector<cv::Mat> templates,
-    std::string name)
+    std::vector<PreparedTemplatePtr> templates,
+    std::string name,
+    std::shared_ptr<const TemplateScoreCache> score_cache)
     : VisionBase(std::move(image), std::move(rois), std::move(name))
     , param_(std::move(param))
     , low_score_better_(param_.method == cv::TemplateMatchModes::TM_SQDIFF || param_.method == cv::TemplateMatchModes::TM_SQDIFF_NORMED)
     , templates_(std::move(templates))
+    , score_cache_(std::move(score_cache))
 {
     analyze();
 }
 
+cv::Mat TemplateMatcher::match_score(const cv::Mat& image, const PreparedTemplate& prepared, int method, bool green_mask)
+{
+    bool invert_score = false;
+    if (method >= TemplateMatcherParam::kMethodInvertBase) {
+        invert_score = true;
+        method -= TemplateMatcherParam::kMethodInvertBase;
+    }
+
+    const cv::Mat& mask = green_mask ? prepared.green_mask : prepared.mask;
+
+    cv::Mat matched;
+    cv::matchTemplate(image, prepared.image, matched, method, mask);
+    if (invert_score) {
+        matched = 1.0f - matched;
+    }
+    return matched;
+}
+
 void TemplateMatcher::analyze()
 {
     if (templates_.empty() || param_.thresholds.empty()) {
@@ -30,87 +83,345 @@ void TemplateMatcher::analyze()
 
     auto start_time = std::chrono::steady_clock::now();
 
+    struct MatchJob
+    {
+        size_t templ_index = 0;
+        cv::Rect roi { };
+        int level = 0;
+        cv::Mat small_image;
+        double threshold = 0.0;
+        ResultsVec results;
+    };
+
+    std::vector<MatchJob> jobs;
+    // 同一 ROI 同一层级的缩小图在所有模板间共享，只算一次
+    std::map<std::pair<size_t, int>, cv::Mat> small_images;
+
     for (size_t i = 0; i != templates_.size(); ++i) {
-        while (next_roi()) {
-            auto results = template_match(templates_.at(i));
-            double threshold = i < param_.thresholds.size() ? param_.thresholds.at(i) : param_.thresholds.back();
-            add_results(std::move(results), threshold);
+        double threshold = i < param_.thresholds.size() ? param_.thresholds.at(i) : param_.thresholds.back();
+        int level = pyramid_level(templates_.at(i)->image.size());
+
+        for (size_t roi_index = 0; next_roi(); ++roi_index) {
+            cv::Mat small_image;
+            if (level > 0) {
+                cv::Mat& cached = small_images[{ roi_index, level }];
+                if (cached.empty()) {
+                    const double factor = 1.0 / (1 << level);
+                    cv::resize(image_with_roi(), cached, cv::Size(), factor, factor, cv::INTER_AREA);
+                }
+                small_image = cached;
+            }
+            jobs.emplace_back(
+                MatchJob {
+                    .templ_index = i,
+                    .roi = roi_,
+                    .level = level,
+                    .small_image = std::move(small_image),
+                    .threshold = threshold,
+                });
         }
         reset_roi();
     }
 
+    // 各 (模板, ROI) 之间互不依赖，交给 OpenCV 的线程池并行跑
+    cv::parallel_for_(cv::Range(0, static_cast<int>(jobs.size())), [&](const cv::Range& range) {
+        for (int j = range.start; j < range.end; ++j) {
+            MatchJob& job = jobs[j];
+            job.results = template_match(templates_.at(job.templ_index), job.roi, job.small_image, job.level, job.threshold);
+        }
+    });
+
+    // 按原先 模板 x ROI 的顺序汇总，保证结果与绘图顺序稳定
+    for (MatchJob& job : jobs) {
+        if (debug_draw_) {
+            roi_ = job.roi;
+            auto draw = draw_result(templates_.at(job.templ_index)->image, job.results);
+            handle_draw(draw);
+        }
+        add_results(std::move(job.results), job.threshold);
+    }
+
     cherry_pick();
 
     auto cost = duration_since(start_time);
     LogDebug << name_ << VAR(all_results_) << VAR(filtered_results_) << VAR(best_result_) << VAR(cost) << VAR(param_.template_)
-             << VAR(templates_.size()) << VAR(param_.thresholds) << VAR(param_.method) << VAR(param_.green_mask);
+             << VAR(templates_.size()) << VAR(param_.thresholds) << VAR(param_.method) << VAR(param_.green_mask)
+             << VAR(param_.pyramid);
+}
+
+template <bool kLowScoreBetter>
+static bool is_better(float s1, float s2)
+{
+    return kLowScoreBetter ? s1 < s2 : s1 > s2;
+}
+
+template <bool kLowScoreBetter>
+static bool is_not_worse(float s1, float s2)
+{
+    return kLowScoreBetter ? s1 <= s2 : s1 >= s2;
 }
 
-TemplateMatcher::ResultsVec TemplateMatcher::template_match(const cv::Mat& templ) const
+// 行优先扫描 matched，收集不差于 floor 的有限值点。local_max 时只保留 3x3 邻域内的局部极值
+template <bool kLowScoreBetter>
+static void scan_candidates(const cv::Mat& matched, float floor, bool local_max, std::vector<cv::Point>& candidates)
 {
-    cv::Mat image = image_with_roi();
+    const int rows = matched.rows;
+    const int cols = matched.cols;
+
+    auto check = [&](int row, int col) {
+        float score = matched.at<float>(row, col);
+        if (!is_not_worse<kLowScoreBetter>(score, floor) || !std::isfinite(score)) {
+            return;
+        }
+
+        if (local_max) {
+            for (int r = std::max(row - 1, 0); r <= std::min(row + 1, rows - 1); ++r) {
+                const float* line = matched.ptr<float>(r);
+                for (int c = std::max(col - 1, 0); c <= std::min(col + 1, cols - 1); ++c) {
+                    float neighbor = line[c];
+                    if (std::isfinite(neighbor) && is_better<kLowScoreBetter>(neighbor, score)) {
+                        return;
+                    }
+                }
+            }
+        }
+        candidates.emplace_back(col, row);
+    };
+
+    for (int row = 0; row < rows; ++row) {
+        const float* line = matched.ptr<float>(row);
+        int col = 0;
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        // 绝大部分像素都达不到下限，按向量宽度整段跳过
+        const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 v_floor = cv::vx_setall_f32(floor);
+        for (; col + lanes <= cols; col += lanes) {
+            cv::v_float32 v_score = cv::vx_load(line + col);
+            cv::v_float32 v_hit = kLowScoreBetter ? cv::v_le(v_score, v_floor) : cv::v_ge(v_score, v_floor);
+            if (!cv::v_check_any(v_hit)) {
+                continue;
+            }
+            for (int c = col; c < col + lanes; ++c) {
+                check(row, c);
+            }
+        }
+#endif
+
+        for (; col < cols; ++col) {
+            check(row, col);
+        }
+    }
+}
+
+TemplateMatcher::ResultsVec TemplateMatcher::template_match(
+    const PreparedTemplatePtr& prepared_ptr,
+    const cv::Rect& roi,
+    const cv::Mat& small_image,
+    int level,
+    double threshold) const
+{
+    const PreparedTemplate& prepared = *prepared_ptr;
+    const cv::Mat& templ = prepared.image;
+    cv::Mat image = image_(roi);
 
     if (templ.cols > image.cols || templ.rows > image.rows) {
         LogError << name_ << "templ size is too large" << VAR(image) << VAR(templ);
         return { };
     }
 
-    bool invert_score = false;
+    cv::Mat matched;
+    if (level > 0) {
+        bool invert_score = false;
+        int method = param_.method;
+        if (method >= TemplateMatcherParam::kMethodInvertBase) {
+            invert_score = true;
+            method -= TemplateMatcherParam::kMethodInvertBase;
+        }
+        const cv::Mat& mask = param_.green_mask ? prepared.green_mask : prepared.mask;
 
-    int method = param_.method;
-    if (method >= TemplateMatcherParam::kMethodInvertBase) {
-        invert_score = true;
-        method -= TemplateMatcherParam::kMethodInvertBase;
+        matched = pyramid_match(image, small_image, templ, mask, method, invert_score, threshold, level);
+    }
+    else if (auto cached = score_cache_ ? score_cache_->get(prepared_ptr, param_.method, param_.green_mask, roi) : std::nullopt) {
+        matched = *std::move(cached);
+    }
+    else {
+        matched = match_score(image, prepared, param_.method, param_.green_mask);
     }
 
-    cv::Mat matched;
-    cv::matchTemplate(image, templ, matched, method, create_mask(templ, param_.green_mask));
+    return extract_peaks(matched, templ.size(), roi);
+}
+
+int TemplateMatcher::pyramid_level(const cv::Size& templ_size) const
+{
+    // 模板缩得太小就没有区分度了，逐级回退，直到 0（不使用金字塔）
+    constexpr int kMinPyramidTemplSize = 8;
+
+    int level = std::clamp(param_.pyramid, 0, TemplateMatcherParam::kMaxPyramid);
+    while (level > 0 && std::min(templ_size.width, templ_size.height) >> level < kMinPyramidTemplSize) {
+        --level;
+    }
+    return level;
+}
 
+cv::Mat TemplateMatcher::pyramid_match(
+    const cv::Mat& image,
+    const cv::Mat& small_image,
+    const cv::Mat& templ,
+    const cv::Mat& mask,
+    int method,
+    bool invert_score,
+    double threshold,
+    int level) const
+{
+    // 低分辨率下的分数会比原图偏低/偏高一些，粗匹配放宽阈值；缩得越狠偏得越多，按层级加宽
+    // 真正的匹配在粗匹配时仍可能掉到放宽后的阈值以外，这是金字塔用召回换速度的代价
+    constexpr double kCoarseMarginBase = 0.1;
+    constexpr double kCoarseMarginPerLevel = 0.05;
+    // 候选多于这个数说明粗匹配区分不开，细化的窗口加起来也快赶上整图了，不如直接整图匹配
+    constexpr size_t kMaxCoarseCandidates = 32;
+
+    const int scale = 1 << level;
+    const double factor = 1.0 / scale;
+
+    auto full_match = [&]() {
+        cv::Mat matched;
+        cv::matchTemplate(image, templ, matched, method, mask);
+        if (invert_score) {
+            matched = 1.0f - matched;
+        }
+        return matched;
+    };
+
+    cv::Mat small_templ;
+    cv::Mat small_mask;
+    cv::resize(templ, small_templ, cv::Size(), factor, factor, cv::INTER_AREA);
+    cv::resize(mask, small_mask, small_templ.size(), 0, 0, cv::INTER_NEAREST);
+
+    if (small_templ.cols > small_image.cols || small_templ.rows > small_image.rows) {
+        // 缩小后取整导致放不下了，直接走原分辨率
+        return full_match();
+    }
+
+    cv::Mat coarse;
+    cv::matchTemplate(small_image, small_templ, coarse, method, small_mask);
     if (invert_score) {
-        matched = 1.0f - matched;
+        coarse = 1.0f - coarse;
     }
 
-    ResultsVec raw_results;
-    Result closest_result;
+    std::vector<cv::Point> candidates;
+    const double margin = kCoarseMarginBase + kCoarseMarginPerLevel * level;
+    const float coarse_floor = static_cast<float>(low_score_better_ ? threshold + margin : threshold - margin);
+    // 粗匹配只需要知道大致位置，每个峰取一个点就够了
     if (low_score_better_) {
-        closest_result.score = std::numeric_limits<float>::max();
+        scan_candidates<true>(coarse, coarse_floor, true, candidates);
+    }
+    else {
+        scan_candidates<false>(coarse, coarse_floor, true, candidates);
     }
-    for (int col = 0; col < matched.cols; ++col) {
-        for (int row = 0; row < matched.rows; ++row) {
-            float score = matched.at<float>(row, col);
-            if (std::isnan(score) || std::isinf(score)) {
-                continue;
-            }
 
-            if (comp_score(closest_result.score, score)) {
-                closest_result.score = score;
-                cv::Rect box(col + roi_.x, row + roi_.y, templ.cols, templ.rows);
-                closest_result.box = box;
-            }
+    if (candidates.size() > kMaxCoarseCandidates) {
+        LogDebug << name_ << "too many coarse candidates, fallback to full search" << VAR(level) << VAR(candidates.size());
+        return full_match();
+    }
 
-            constexpr float kThreshold = 0.5f;
-            if (comp_score(score, kThreshold)) {
-                continue;
+    // 粗匹配一个都没过，也至少细化一下最接近的位置，保证 all_results 有东西
+    if (candidates.empty()) {
+        std::optional<cv::Point> closest;
+        for (int row = 0; row < coarse.rows; ++row) {
+            const float* line = coarse.ptr<float>(row);
+            for (int col = 0; col < coarse.cols; ++col) {
+                if (!std::isfinite(line[col])) {
+                    continue;
+                }
+                if (!closest || comp_score(coarse.at<float>(*closest), line[col])) {
+                    closest = cv::Point(col, row);
+                }
             }
+        }
+        if (closest) {
+            candidates.emplace_back(*closest);
+        }
+    }
 
-            cv::Rect box(col + roi_.x, row + roi_.y, templ.cols, templ.rows);
-            Result result { .box = box, .score = score };
-            raw_results.emplace_back(result);
+    // 未细化的位置填 NaN，extract_peaks 会直接跳过
+    const cv::Size matched_size(image.cols - templ.cols + 1, image.rows - templ.rows + 1);
+    cv::Mat matched(matched_size, CV_32FC1, cv::Scalar(std::numeric_limits<float>::quiet_NaN()));
+
+    const int radius = scale + 1;
+    for (const cv::Point& pt : candidates) {
+        int x = std::clamp(pt.x * scale - radius, 0, matched.cols - 1);
+        int y = std::clamp(pt.y * scale - radius, 0, matched.rows - 1);
+        int width = std::min(2 * radius + 1, matched.cols - x);
+        int height = std::min(2 * radius + 1, matched.rows - y);
+        cv::Rect window(x, y, width, height);
+
+        cv::Mat refined;
+        cv::matchTemplate(image(cv::Rect(x, y, width + templ.cols - 1, height + templ.rows - 1)), templ, refined, method, mask);
+        if (invert_score) {
+            refined = 1.0f - refined;
         }
+        refined.copyTo(matched(window));
     }
-    // At least there is a result
-    if (raw_results.empty()) {
-        raw_results.emplace_back(closest_result);
+
+    LogDebug << name_ << VAR(level) << VAR(candidates.size()) << VAR(image.size()) << VAR(templ.size());
+
+    return matched;
+}
+
+TemplateMatcher::ResultsVec TemplateMatcher::extract_peaks(const cv::Mat& matched, const cv::Size& templ_size, const cv::Rect& roi) const
+{
+    // 不差于 kThreshold 的点全部进 NMS，和逐点扫描时的候选集合完全一样，不受本节点 threshold 影响
+    constexpr float kThreshold = 0.5f;
+
+    std::vector<cv::Point> candidates;
+    if (low_score_better_) {
+        scan_candidates<true>(matched, kThreshold, false, candidates);
+    }
+    else {
+        scan_candidates<false>(matched, kThreshold, false, candidates);
     }
 
-    auto nms_results = NMS(std::move(raw_results), 0.2, !low_score_better_);
+    // NMS 的排序不稳定，同分时的先后取决于输入顺序，这里还原成按列优先的顺序
+    std::ranges::sort(candidates, [](const cv::Point& lhs, const cv::Point& rhs) {
+        return lhs.x != rhs.x ? lhs.x < rhs.x : lhs.y < rhs.y;
+    });
 
-    if (debug_draw_) {
-        auto draw = draw_result(templ, nms_results);
-        handle_draw(draw);
+    ResultsVec raw_results;
+    raw_results.reserve(candidates.size());
+    for (const cv::Point& pt : candidates) {
+        cv::Rect box(pt.x + roi.x, pt.y + roi.y, templ_size.width, templ_size.height);
+        raw_results.emplace_back(Result { .box = box, .score = matched.at<float>(pt) });
+    }
+
+    // At least there is a result
+    if (raw_results.empty()) {
+        Result closest_result;
+        if (low_score_better_) {
+            closest_result.score = std::numeric_limits<float>::max();
+        }
+        std::optional<int> closest_col;
+        for (int row = 0; row < matched.rows; ++row) {
+            const float* line = matched.ptr<float>(row);
+            for (int col = 0; col < matched.cols; ++col) {
+                float score = line[col];
+                if (!std::isfinite(score)) {
+                    continue;
+                }
+                // 同分时取列优先顺序下的第一个
+                bool earlier_tie = closest_col && score == closest_result.score && col < *closest_col;
+                if (!comp_score(closest_result.score, score) && !earlier_tie) {
+                    continue;
+                }
+                closest_result.score = score;
+                closest_result.box = cv::Rect(col + roi.x, row + roi.y, templ_size.width, templ_size.height);
+                closest_col = col;
+            }
+        }
+        raw_results.emplace_back(closest_result);
     }
 
-    return nms_results;
+    return NMS(std::move(raw_results), 0.2, !low_score_better_);
 }
 
 cv::Mat TemplateMatcher::draw_result(const cv::Mat& templ, const ResultsVec& results) const
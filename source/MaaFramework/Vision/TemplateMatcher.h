@@ -1,6 +1,9 @@
 #pragma once
 
+#include <map>
+#include <optional>
 #include <ostream>
+#include <tuple>
 #include <vector>
 
 #include "MaaUtils/JsonExt.hpp"
@@ -19,6 +22,21 @@ struct TemplateMatcherResult
     MEO_JSONIZATION(box, score);
 };
 
+// 同一帧内多个节点共享的得分图。相互重叠的 ROI 合并后只 matchTemplate 一次，各节点再按自己的 ROI 裁出对应部分
+// 只在识别开始前的规划阶段由一个线程 set，之后以 shared_ptr<const> 交给各识别线程只读，不加锁；共享出去后不能再写
+// 按 PreparedTemplatePtr 持有模板，缓存存活期间模板不会被释放，也就不会有地址复用到别的模板上的问题
+class TemplateScoreCache
+{
+public:
+    void set(PreparedTemplatePtr templ, int method, bool green_mask, const cv::Rect& area, cv::Mat score);
+    std::optional<cv::Mat> get(const PreparedTemplatePtr& templ, int method, bool green_mask, const cv::Rect& roi) const;
+
+private:
+    using Key = std::tuple<PreparedTemplatePtr, int, bool>;
+
+    std::map<Key, std::vector<std::pair<cv::Rect, cv::Mat>>> scores_;
+};
+
 class TemplateMatcher
     : public VisionBase
     , public RecoResultAPI<TemplateMatcherResult>
@@ -28,12 +46,29 @@ public:
         cv::Mat image,
         std::vector<cv::Rect> rois,
         TemplateMatcherParam param,
-        std::vector<cv::Mat> templates,
-        std::string name = "");
+        std::vector<PreparedTemplatePtr> templates,
+        std::string name = "",
+        std::shared_ptr<const TemplateScoreCache> score_cache = nullptr);
+
+    // method 可以带 kMethodInvertBase，返回的得分图已经反转过
+    static cv::Mat match_score(const cv::Mat& image, const PreparedTemplate& prepared, int method, bool green_mask);
 
 private:
     void analyze();
-    ResultsVec template_match(const cv::Mat& templ) const;
+    ResultsVec
+        template_match(const PreparedTemplatePtr& prepared, const cv::Rect& roi, const cv::Mat& small_image, int level, double threshold)
+            const;
+    int pyramid_level(const cv::Size& templ_size) const;
+    cv::Mat pyramid_match(
+        const cv::Mat& image,
+        const cv::Mat& small_image,
+        const cv::Mat& templ,
+        const cv::Mat& mask,
+        int method,
+        bool invert_score,
+        double threshold,
+        int level) const;
+    ResultsVec extract_peaks(const cv::Mat& matched, const cv::Size& templ_size, const cv::Rect& roi) const;
 
     void add_results(ResultsVec results, double threshold);
     void cherry_pick();
@@ -48,7 +83,8 @@ private:
 private:
     const TemplateMatcherParam param_;
     const bool low_score_better_ = false;
-    const std::vector<cv::Mat> templates_;
+    const std::vector<PreparedTemplatePtr> templates_;
+    std::shared_ptr<const TemplateScoreCache> score_cache_ = nullptr;
 };
 
 MAA_VISION_NS_END
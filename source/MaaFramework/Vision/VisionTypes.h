@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -64,11 +66,13 @@ struct TemplateMatcherParam : public RoiTargetParamBase
     inline static constexpr double kDefaultThreshold = 0.7;
     inline static constexpr int kDefaultMethod = 5; // cv::TM_CCOEFF_NORMED
     inline static constexpr int kMethodInvertBase = 10000;
+    inline static constexpr int kMaxPyramid = 8; // 再往下模板早就不足 8 像素了
 
     std::vector<std::string> template_;
     std::vector<double> thresholds = { kDefaultThreshold };
     int method = kDefaultMethod;
     bool green_mask = false;
+    int pyramid = 0; // 金字塔下采样层数，0 为不启用
 
     ResultOrderBy order_by = ResultOrderBy::Horizontal;
     int result_index = 0;
@@ -181,6 +185,32 @@ struct FeatureMatcherParam : public RoiTargetParamBase
     int result_index = 0;
 };
 
+struct FeatureSet
+{
+    std::vector<cv::KeyPoint> keypoints;
+    cv::Mat descriptors;
+};
+
+// 模板图的预处理结果，由 TemplateResMgr 持有并在各次识别、各线程间共享
+// image / gray / mask / green_mask 在 prepare_template 里算好，之后只读，读时不加锁
+// 唯一会变的是 features：首次用到时在 features_mutex 下插入，之后不修改也不删除，
+// std::map 的元素地址稳定，所以插入完成后返回的引用可以在锁外一直使用
+struct PreparedTemplate
+{
+    using FeatureKey = std::pair<FeatureMatcherParam::Detector, /*green_mask*/ bool>;
+
+    cv::Mat image;
+    cv::Mat gray;
+    cv::Mat mask;       // 全 1
+    cv::Mat green_mask; // 绿色 (0, 255, 0) 部分为 0
+
+    // FeatureMatch 用到时才计算，按 (detector, green_mask) 缓存。只能在持有 features_mutex 时查找和插入
+    mutable std::mutex features_mutex;
+    mutable std::map<FeatureKey, FeatureSet> features;
+};
+
+using PreparedTemplatePtr = std::shared_ptr<const PreparedTemplate>;
+
 struct RectComparator
 {
     bool operator()(const cv::Rect& lhs, const cv::Rect& rhs) const
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <numeric>
 #include <optional>
 #include <random>
@@ -10,6 +11,7 @@
 #include "Common/Conf.h"
 #include "MaaUtils/Logger.h"
 #include "MaaUtils/NoWarningCV.hpp"
+#include "VisionTypes.h"
 
 MAA_VISION_NS_BEGIN
 
@@ -181,29 +183,23 @@ inline static std::optional<size_t> pythonic_index(size_t total, int index)
 }
 
 // Non-Maximum Suppression
+// 被抑制的结果不会再去抑制别人，只和已保留的比较即可，结果与两两比较完全一样
 template <typename ResultsVec>
 inline static ResultsVec NMS(ResultsVec results, double threshold = 0.7, bool greater = true)
 {
     std::ranges::sort(results, [&](const auto& a, const auto& b) { return greater ? (a.score > b.score) : (a.score < b.score); });
 
     ResultsVec nms_results;
-    for (size_t i = 0; i < results.size(); ++i) {
-        const auto& res1 = results[i];
-        if ((greater && res1.score < 0.1f) || (!greater && res1.score > 0.9f)) {
+    for (auto& res : results) {
+        if ((greater && res.score < 0.1f) || (!greater && res.score > 0.9f)) {
             continue;
         }
-        auto res1_box = res1.box;
-        nms_results.emplace_back(std::move(res1));
-
-        for (size_t j = i + 1; j < results.size(); ++j) {
-            auto& res2 = results[j];
-            if ((greater && res2.score < 0.1f) || (!greater && res2.score > 0.9f)) {
-                continue;
-            }
-            int iou_area = (res1_box & res2.box).area();
-            if (iou_area >= threshold * res2.box.area()) {
-                res2.score = greater ? 0 : 1;
-            }
+        bool suppressed = std::ranges::any_of(nms_results, [&](const auto& kept) {
+            int iou_area = (kept.box & res.box).area();
+            return iou_area >= threshold * res.box.area();
+        });
+        if (!suppressed) {
+            nms_results.emplace_back(std::move(res));
         }
     }
     return nms_results;
@@ -262,38 +258,34 @@ inline static void merge_vector_(ResultsVec& left, ResultsVec right)
     left.insert(left.end(), std::make_move_iterator(right.begin()), std::make_move_iterator(right.end()));
 }
 
-inline static cv::Mat hwc_to_chw(const cv::Mat& src)
+// BGR 8UC3 图像一次遍历写成 RGB、CHW、归一化到 [0, 1] 的 float 张量，dst 至少要有 rows * cols * 3 个元素
+// 缩放不并进来：INTER_AREA 的非整数倍缩放要按面积加权，cv::resize 已有向量化实现，自己再写一遍结果还会有出入
+inline static bool bgr_to_chw_tensor(const cv::Mat& image, float* dst)
 {
-    std::vector<cv::Mat> rgb_images;
-    cv::split(src, rgb_images);
-
-    // Stretch one-channel image to vector
-    cv::Mat flat_r = rgb_images[0].reshape(1, 1);
-    cv::Mat flat_g = rgb_images[1].reshape(1, 1);
-    cv::Mat flat_b = rgb_images[2].reshape(1, 1);
-
-    // Now we can rearrange channels if need
-    cv::Mat matArray[] = { flat_r, flat_g, flat_b };
-
-    cv::Mat flat_image;
-    // Concatenate three vectors to one
-    cv::hconcat(matArray, 3, flat_image);
-    return flat_image;
-}
-
-inline static std::vector<float> image_to_tensor(const cv::Mat& image)
-{
-    cv::Mat src = image.clone();
-    cv::cvtColor(src, src, cv::COLOR_BGR2RGB);
-
-    cv::Mat chw = hwc_to_chw(src);
-    cv::Mat chw_32f;
-    chw.convertTo(chw_32f, CV_32F, 1.0 / 255.0);
-
-    size_t tensor_size = 1ULL * src.cols * src.rows * src.channels();
-    std::vector<float> tensor(tensor_size);
-    std::memcpy(tensor.data(), chw_32f.data, tensor_size * sizeof(float));
-    return tensor;
+    if (image.type() != CV_8UC3) {
+        LogError << "image type is not CV_8UC3" << VAR(image.type());
+        return false;
+    }
+
+    const int rows = image.rows;
+    const int cols = image.cols;
+    const size_t plane = static_cast<size_t>(rows) * cols;
+    constexpr float kScale = 1.0f / 255.0f;
+
+    float* dst_r = dst;
+    float* dst_g = dst + plane;
+    float* dst_b = dst + plane * 2;
+
+    for (int y = 0; y < rows; ++y) {
+        const uchar* src = image.ptr<uchar>(y);
+        const size_t offset = static_cast<size_t>(y) * cols;
+        for (int x = 0; x < cols; ++x) {
+            dst_b[offset + x] = src[x * 3] * kScale;
+            dst_g[offset + x] = src[x * 3 + 1] * kScale;
+            dst_r[offset + x] = src[x * 3 + 2] * kScale;
+        }
+    }
+    return true;
 }
 
 // 将支持负数的矩形转换为标准矩形：
@@ -418,4 +410,30 @@ inline cv::Mat create_mask(const cv::Mat& image, const cv::Rect& roi)
     return mask;
 }
 
+inline PreparedTemplatePtr prepare_template(cv::Mat image)
+{
+    if (image.empty()) {
+        return nullptr;
+    }
+
+    auto prepared = std::make_shared<PreparedTemplate>();
+
+    switch (image.channels()) {
+    case 1:
+        prepared->gray = image;
+        break;
+    case 4:
+        cv::cvtColor(image, prepared->gray, cv::COLOR_BGRA2GRAY);
+        break;
+    default:
+        cv::cvtColor(image, prepared->gray, cv::COLOR_BGR2GRAY);
+        break;
+    }
+    prepared->mask = create_mask(image, false);
+    prepared->green_mask = create_mask(image, true);
+    prepared->image = std::move(image);
+
+    return prepared;
+}
+
 MAA_VISION_NS_END
@@ -183,8 +183,28 @@ bool WaylandClient::screencap(void** buffer, uint32_t& width, uint32_t& height,
         return false;
     }
 
+    return capture(zwlr_screencopy_manager_v1_capture_output(screencopy_manager_.get(), 0, output_.get()), buffer, width, height, format);
+}
+
+bool WaylandClient::screencap_region(int x, int y, int w, int h, void** buffer, uint32_t& width, uint32_t& height, uint32_t& format)
+{
+    if (!connected_) {
+        return false;
+    }
+
+    // 坐标是 output 的逻辑坐标，缩放不为 1 时拿到的 buffer 尺寸会和 w、h 不同，由调用方检查
+    return capture(
+        zwlr_screencopy_manager_v1_capture_output_region(screencopy_manager_.get(), 0, output_.get(), x, y, w, h),
+        buffer,
+        width,
+        height,
+        format);
+}
+
+bool WaylandClient::capture(zwlr_screencopy_frame_v1* frame, void** buffer, uint32_t& width, uint32_t& height, uint32_t& format)
+{
     std::unique_ptr<zwlr_screencopy_frame_v1> screencopy_frame;
-    screencopy_frame.reset(zwlr_screencopy_manager_v1_capture_output(screencopy_manager_.get(), 0, output_.get()));
+    screencopy_frame.reset(frame);
 
     zwlr_screencopy_frame_v1_listener frame_listener = { };
     frame_listener.buffer = [](void* data, zwlr_screencopy_frame_v1* frame, uint32_t format, uint32_t w, uint32_t h, uint32_t stride) {
@@ -32,6 +32,7 @@ public:
     bool connected() const;
 
     bool screencap(void** buffer, uint32_t& width, uint32_t& height, uint32_t& format);
+    bool screencap_region(int x, int y, int w, int h, void** buffer, uint32_t& width, uint32_t& height, uint32_t& format);
     bool pointer(EventPhase phase, int x, int y, int contact);
     bool input_key(EventPhase phase, int key);
     bool input_str(const std::string& str);
@@ -50,6 +51,8 @@ private:
     bool bind_protocol();
     bool prepare_device();
     bool prepare_keymap();
+    // Capture
+    bool capture(zwlr_screencopy_frame_v1* frame, void** buffer, uint32_t& width, uint32_t& height, uint32_t& format);
     // Buffer
     bool check_buffer(int format, int width, int height, int stride) const;
     bool create_buffer(int format, int width, int height, int stride);
@@ -92,6 +92,33 @@ bool WlRootsControlUnitMgr::screencap(cv::Mat& image)
         LogError << "Failed to screencap";
         return false;
     }
+
+    convert_buffer(buffer, width, height, format, image);
+    return true;
+}
+
+bool WlRootsControlUnitMgr::screencap_region(const cv::Rect& roi, cv::Mat& image)
+{
+    uint32_t width, height = 0;
+    uint32_t format = 0;
+    void* buffer;
+
+    if (!client_) {
+        LogError << "client_ is nullptr";
+        return false;
+    }
+
+    if (!client_->screencap_region(roi.x, roi.y, roi.width, roi.height, &buffer, width, height, format)) {
+        LogError << "Failed to screencap region" << VAR(roi);
+        return false;
+    }
+
+    convert_buffer(buffer, width, height, format, image);
+    return true;
+}
+
+void WlRootsControlUnitMgr::convert_buffer(void* buffer, uint32_t width, uint32_t height, uint32_t format, cv::Mat& image)
+{
     int cvt_mode = cv::COLOR_RGBA2BGR;
     switch (format) { // TODO: Other possible format?
     case WL_SHM_FORMAT_XBGR8888:
@@ -110,7 +137,6 @@ bool WlRootsControlUnitMgr::screencap(cv::Mat& image)
     const cv::Mat raw(height, width, CV_8UC4, buffer);
 
     cv::cvtColor(raw, image, cvt_mode);
-    return true;
 }
 
 bool WlRootsControlUnitMgr::click(int x, int y)
@@ -31,6 +31,8 @@ public:
     virtual bool stop_app(const std::string& intent) override;
 
     virtual bool screencap(cv::Mat& image) override;
+    virtual bool support_screencap_region() const override { return true; }
+    virtual bool screencap_region(const cv::Rect& roi, cv::Mat& image) override;
 
     virtual bool click(int x, int y) override;
     virtual bool swipe(int x1, int y1, int x2, int y2, int duration) override;
@@ -50,6 +52,8 @@ public:
     virtual json::object get_info() const override;
 
 private:
+    void convert_buffer(void* buffer, uint32_t width, uint32_t height, uint32_t format, cv::Mat& image);
+
     std::unique_ptr<WaylandClient> client_;
     std::filesystem::path wlr_socket_path_;
     std::pair<int, int> last_pos_ = { 0, 0 };
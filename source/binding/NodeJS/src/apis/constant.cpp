@@ -31,6 +31,7 @@ static maajs::ValueType load_adb_screencap_method(maajs::EnvType env)
     DEM(MaaAdbScreencapMethod, MinicapDirect);
     DEM(MaaAdbScreencapMethod, MinicapStream);
     DEM(MaaAdbScreencapMethod, EmulatorExtras);
+    DEM(MaaAdbScreencapMethod, RawStream);
     DEM(MaaAdbScreencapMethod, All);
     DEM(MaaAdbScreencapMethod, Default);
 
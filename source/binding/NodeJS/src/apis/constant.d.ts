@@ -8,11 +8,13 @@ declare global {
          * Use bitwise OR to set the methods you need.
          * MaaFramework will test all provided methods and use the fastest available one.
          *
-         * Default: All methods except RawByNetcat, MinicapDirect, MinicapStream
+         * Default: All methods except RawByNetcat, MinicapDirect, MinicapStream, RawStream
          *
          * Note: MinicapDirect and MinicapStream use lossy JPEG encoding, which may
          * significantly reduce template matching accuracy. Not recommended.
          *
+         * Note: MinicapStream and RawStream keep capturing on the device in the background.
+         *
          * | Method                | Speed      | Compatibility | Encoding | Notes                             |
          * |-----------------------|------------|---------------|----------|-----------------------------------|
          * | EncodeToFileAndPull   | Slow       | High          | Lossless |                                   |
@@ -22,6 +24,7 @@ declare global {
          * | MinicapDirect         | Fast       | Low           | Lossy    |                                   |
          * | MinicapStream         | Very Fast  | Low           | Lossy    |                                   |
          * | EmulatorExtras        | Very Fast  | Low           | Lossless | Emulators only: MuMu 12, LDPlayer 9 |
+         * | RawStream             | Fast       | Medium        | Lossless |                                   |
          */
         const AdbScreencapMethod: Record<
             | 'EncodeToFileAndPull'
@@ -31,6 +34,7 @@ declare global {
             | 'MinicapDirect'
             | 'MinicapStream'
             | 'EmulatorExtras'
+            | 'RawStream'
             | 'All'
             | 'Default',
             ScreencapOrInputMethods
@@ -99,6 +99,13 @@ void set_reco_image_cache_limit(size_t value)
     }
 }
 
+void set_parallel_next_list(bool value)
+{
+    if (!MaaGlobalSetOption(MaaGlobalOption_ParallelNextList, &value, sizeof(value))) {
+        throw maajs::MaaError { "Global set parallel_next_list failed" };
+    }
+}
+
 void config_init_option(std::string user_path, maajs::OptionalParam<std::string> default_json)
 {
 #ifdef MAA_JS_WITH_TOOLKIT
@@ -136,6 +143,7 @@ maajs::ObjectType load_global(maajs::EnvType env)
     MAA_BIND_SETTER(globalObject, "debug_mode", set_debug_mode);
     MAA_BIND_SETTER(globalObject, "draw_quality", set_draw_quality);
     MAA_BIND_SETTER(globalObject, "reco_image_cache_limit", set_reco_image_cache_limit);
+    MAA_BIND_SETTER(globalObject, "parallel_next_list", set_parallel_next_list);
     MAA_BIND_FUNC(globalObject, "config_init_option", config_init_option);
     MAA_BIND_FUNC(globalObject, "resize_image", resize_image);
 
@@ -12,6 +12,7 @@ declare global {
             set debug_mode(value: boolean)
             set draw_quality(value: number)
             set reco_image_cache_limit(value: number)
+            set parallel_next_list(value: boolean)
             config_init_option(user_path: string, default_json?: string): void
 
             resize_image(image: ArrayBuffer, width: number, height: number): ArrayBuffer
@@ -48,6 +48,7 @@ declare global {
                 index?: number
                 method?: 10001 | 3 | 5
                 green_mask?: boolean
+                pyramid?: number
             },
             'template',
             Mode
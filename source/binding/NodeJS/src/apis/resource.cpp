@@ -132,6 +132,13 @@ void ResourceImpl::set_inference_execution_provider(std::string provider)
     }
 }
 
+void ResourceImpl::set_ocr_session_pool_size(int32_t size)
+{
+    if (!MaaResourceSetOption(resource, MaaResOption_OCRSessionPoolSize, &size, sizeof(size))) {
+        throw maajs::MaaError { "Resource set ocr_session_pool_size failed" };
+    }
+}
+
 void ResourceImpl::register_custom_recognition(std::string key, maajs::FunctionType func)
 {
     auto ctx = new maajs::CallbackContext(func, "CustomReco");
@@ -315,6 +322,15 @@ bool ResourceImpl::get_loaded()
     return MaaResourceLoaded(resource);
 }
 
+std::optional<maajs::ValueType> ResourceImpl::get_ocr_session_pool_stats()
+{
+    StringBuffer buffer;
+    if (!MaaResourceGetOCRSessionPoolStats(resource, buffer)) {
+        return std::nullopt;
+    }
+    return maajs::JsonParse(env, buffer.str());
+}
+
 std::optional<std::string> ResourceImpl::get_hash()
 {
     StringBuffer buf;
@@ -419,6 +435,7 @@ void ResourceImpl::init_proto(maajs::ObjectType proto, maajs::FunctionType)
     MAA_BIND_FUNC(proto, "post_image", ResourceImpl::post_image);
     MAA_BIND_SETTER(proto, "inference_device", ResourceImpl::set_inference_device);
     MAA_BIND_SETTER(proto, "inference_execution_provider", ResourceImpl::set_inference_execution_provider);
+    MAA_BIND_SETTER(proto, "ocr_session_pool_size", ResourceImpl::set_ocr_session_pool_size);
     MAA_BIND_FUNC(proto, "override_pipeline", ResourceImpl::override_pipeline);
     MAA_BIND_FUNC(proto, "override_next", ResourceImpl::override_next);
     MAA_BIND_FUNC(proto, "override_image", ResourceImpl::override_image);
@@ -431,6 +448,7 @@ void ResourceImpl::init_proto(maajs::ObjectType proto, maajs::FunctionType)
     MAA_BIND_FUNC(proto, "wait", ResourceImpl::wait);
     MAA_BIND_GETTER(proto, "loaded", ResourceImpl::get_loaded);
     MAA_BIND_GETTER(proto, "hash", ResourceImpl::get_hash);
+    MAA_BIND_GETTER(proto, "ocr_session_pool_stats", ResourceImpl::get_ocr_session_pool_stats);
     MAA_BIND_GETTER(proto, "node_list", ResourceImpl::get_node_list);
     MAA_BIND_GETTER(proto, "custom_recognition_list", ResourceImpl::get_custom_recognition_list);
     MAA_BIND_GETTER(proto, "custom_action_list", ResourceImpl::get_custom_action_list);
@@ -18,6 +18,7 @@ declare global {
             set inference_execution_provider(
                 provider: 'Auto' | 'CPU' | 'DirectML' | 'CoreML' | 'CUDA',
             )
+            set ocr_session_pool_size(size: number)
 
             register_custom_recognition(name: string, func: CustomRecognitionCallback): void
             unregister_custom_recognition(name: string): void
@@ -47,6 +48,18 @@ declare global {
             wait(id: ResId): Promise<Status>
             get loaded(): boolean
             get hash(): string | null
+            get ocr_session_pool_stats(): Record<
+                string,
+                {
+                    capacity: number
+                    created: number
+                    idle: number
+                    acquired: number
+                    waited: number
+                    total_wait_us: number
+                    max_wait_us: number
+                }
+            > | null
             get node_list(): string[] | null
             get custom_recognition_list(): string[] | null
             get custom_action_list(): string[] | null
@@ -26,6 +26,7 @@ struct ResourceImpl : public maajs::NativeClassBase
     void clear_sinks();
     void set_inference_device(std::variant<std::string, int32_t> id);
     void set_inference_execution_provider(std::string provider);
+    void set_ocr_session_pool_size(int32_t size);
     void register_custom_recognition(std::string name, maajs::FunctionType func);
     void unregister_custom_recognition(std::string name);
     void clear_custom_recognition();
@@ -48,6 +49,7 @@ struct ResourceImpl : public maajs::NativeClassBase
     maajs::PromiseType wait(MaaResId id);
     bool get_loaded();
     std::optional<std::string> get_hash();
+    std::optional<maajs::ValueType> get_ocr_session_pool_stats();
     std::optional<std::vector<std::string>> get_node_list();
     std::optional<std::vector<std::string>> get_custom_recognition_list();
     std::optional<std::vector<std::string>> get_custom_action_list();
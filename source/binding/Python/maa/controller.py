@@ -488,6 +488,28 @@ class Controller:
             )
         )
 
+    def set_continuous_screencap(self, max_age_ms: int) -> bool:
+        """设置后台连续截图 / Set continuous screencap in background
+
+        截图耗时会与识别重叠，获取截图时直接取后台最新的一帧
+        Capture latency overlaps with recognition, screencap takes the latest background frame
+
+        Args:
+            max_age_ms: 可接受的最大帧龄（毫秒），0 为关闭 / Max acceptable frame age in milliseconds, 0 to disable
+
+        Returns:
+            bool: 是否成功 / Whether successful
+        """
+        cint = ctypes.c_int32(max_age_ms)
+        return bool(
+            Library.framework().MaaControllerSetOption(
+                self._handle,
+                MaaOption(MaaCtrlOptionEnum.ContinuousScreencap),
+                ctypes.pointer(cint),
+                ctypes.sizeof(ctypes.c_int32),
+            )
+        )
+
     _sink_holder: Dict[int, "ControllerEventSink"] = {}
 
     def add_sink(self, sink: "ControllerEventSink") -> Optional[int]:
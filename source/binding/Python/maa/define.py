@@ -108,6 +108,13 @@ class MaaGlobalOptionEnum(IntEnum):
     # default value is 4096
     RecoImageCacheLimit = 9
 
+    # Whether to evaluate the candidates of a node's next list concurrently
+    # The first hit in list order is still the one taken. Nodes using Custom recognition are always run sequentially.
+    #
+    # value: bool, eg: true; val_size: sizeof(bool)
+    # default value is false
+    ParallelNextList = 10
+
 
 class MaaCtrlOptionEnum(IntEnum):
     Invalid = 0
@@ -131,6 +138,11 @@ class MaaCtrlOptionEnum(IntEnum):
     # value: bool, eg: true; val_size: sizeof(bool)
     # Recording = 5
 
+    # Keep capturing screenshots in background, so that capture latency overlaps with recognition.
+    # The value is the max age of a frame that can still be used, 0 to disable.
+    # value: int, milliseconds, eg: 100; val_size: sizeof(int)
+    ContinuousScreencap = 6
+
 
 class MaaInferenceDeviceEnum(IntEnum):
     CPU = -2
@@ -178,6 +190,13 @@ class MaaResOptionEnum(IntEnum):
     # default value is MaaInferenceExecutionProvider_Auto
     InferenceExecutionProvider = 2
 
+    # Max number of OCR model instances kept per model, shared by all taskers using this resource.
+    # Larger values let taskers run OCR concurrently at the cost of memory.
+    #
+    # value: int32_t, eg: 4; val_size: sizeof(int32_t)
+    # default value is 2
+    OCRSessionPoolSize = 3
+
 
 MaaAdbScreencapMethod = ctypes.c_uint64
 
@@ -189,11 +208,13 @@ class MaaAdbScreencapMethodEnum(IntEnum):
     Use bitwise OR to set the methods you need.
     MaaFramework will test all provided methods and use the fastest available one.
 
-    Default: All methods except RawByNetcat, MinicapDirect, MinicapStream
+    Default: All methods except RawByNetcat, MinicapDirect, MinicapStream, RawStream
 
     Note: MinicapDirect and MinicapStream use lossy JPEG encoding, which may
     significantly reduce template matching accuracy. Not recommended.
 
+    Note: MinicapStream and RawStream keep capturing on the device in the background.
+
     | Method                | Speed      | Compatibility | Encoding | Notes                             |
     |-----------------------|------------|---------------|----------|-----------------------------------|
     | EncodeToFileAndPull   | Slow       | High          | Lossless |                                   |
@@ -203,6 +224,7 @@ class MaaAdbScreencapMethodEnum(IntEnum):
     | MinicapDirect         | Fast       | Low           | Lossy    |                                   |
     | MinicapStream         | Very Fast  | Low           | Lossy    |                                   |
     | EmulatorExtras        | Very Fast  | Low           | Lossless | Emulators only: MuMu 12, LDPlayer 9 |
+    | RawStream             | Fast       | Medium        | Lossless |                                   |
     """
 
     Null = 0
@@ -214,9 +236,10 @@ class MaaAdbScreencapMethodEnum(IntEnum):
     MinicapDirect = 1 << 4
     MinicapStream = 1 << 5
     EmulatorExtras = 1 << 6
+    RawStream = 1 << 7
 
     All = ~Null
-    Default = All & (~RawByNetcat) & (~MinicapDirect) & (~MinicapStream)
+    Default = All & (~RawByNetcat) & (~MinicapDirect) & (~MinicapStream) & (~RawStream)
 
 
 MaaAdbInputMethod = ctypes.c_uint64
@@ -63,6 +63,7 @@ class JTemplateMatch:
     index: int = 0
     method: int = 5
     green_mask: bool = False
+    pyramid: int = 0
 
 
 @dataclass
@@ -347,6 +347,28 @@ class Resource:
             MaaInferenceExecutionProviderEnum.Auto, MaaInferenceDeviceEnum.Auto
         )
 
+    def set_ocr_session_pool_size(self, size: int) -> bool:
+        """设置每个 OCR 模型的实例池大小 / Set the instance pool size of each OCR model
+
+        多个 tasker 共享同一个资源时，最多可以同时有这么多个 OCR 推理
+        Up to this many OCR inferences can run concurrently when taskers share the resource
+
+        Args:
+            size: 池大小，需大于 0，默认为 2 / Pool size, must be greater than 0, default is 2
+
+        Returns:
+            bool: 是否成功 / Whether successful
+        """
+        csize = ctypes.c_int32(size)
+        return bool(
+            Library.framework().MaaResourceSetOption(
+                self._handle,
+                MaaResOptionEnum.OCRSessionPoolSize,
+                ctypes.pointer(csize),
+                ctypes.sizeof(ctypes.c_int32),
+            )
+        )
+
     # not implemented
     # def use_cuda(self, nvidia_gpu_id: int) -> bool:
     #     return self.set_inference(MaaInferenceExecutionProviderEnum.CUDA, nvidia_gpu_id)
@@ -562,6 +584,23 @@ class Resource:
             raise RuntimeError("Failed to get custom action list.")
         return buffer.get()
 
+    @property
+    def ocr_session_pool_stats(self) -> Dict[str, Dict[str, int]]:
+        """获取 OCR 模型实例池统计 / Get OCR session pool statistics
+
+        Returns:
+            Dict[str, Dict[str, int]]: 以模型名为键的统计信息 / Stats keyed by OCR model name
+
+        Raises:
+            RuntimeError: 如果获取失败
+        """
+        buffer = StringBuffer()
+        if not Library.framework().MaaResourceGetOCRSessionPoolStats(
+            self._handle, buffer._handle
+        ):
+            raise RuntimeError("Failed to get ocr session pool stats.")
+        return json.loads(buffer.get())
+
     @property
     def hash(self) -> str:
         """获取资源 hash / Get resource hash
@@ -806,6 +845,12 @@ class Resource:
             MaaStringBufferHandle,
         ]
 
+        Library.framework().MaaResourceGetOCRSessionPoolStats.restype = MaaBool
+        Library.framework().MaaResourceGetOCRSessionPoolStats.argtypes = [
+            MaaResourceHandle,
+            MaaStringBufferHandle,
+        ]
+
         Library.framework().MaaResourceAddSink.restype = MaaSinkId
         Library.framework().MaaResourceAddSink.argtypes = [
             MaaResourceHandle,
@@ -721,6 +721,25 @@ class Tasker:
             )
         )
 
+    @staticmethod
+    def set_parallel_next_list(parallel: bool) -> bool:
+        """设置是否并行识别 next 列表 / Set whether to evaluate the next list concurrently
+
+        Args:
+            parallel: 是否并行，默认 False / Whether to run in parallel, default False
+
+        Returns:
+            bool: 是否成功 / Whether successful
+        """
+        cbool = ctypes.c_bool(parallel)
+        return bool(
+            Library.framework().MaaGlobalSetOption(
+                MaaOption(MaaGlobalOptionEnum.ParallelNextList),
+                ctypes.pointer(cbool),
+                ctypes.sizeof(ctypes.c_bool),
+            )
+        )
+
     @staticmethod
     def load_plugin(path: Union[Path, str]) -> bool:
         """加载插件 / Load plugin
@@ -67,6 +67,8 @@ public:
 
     virtual std::optional<json::object> get_default_recognition_param(const std::string& reco_type) const = 0;
     virtual std::optional<json::object> get_default_action_param(const std::string& action_type) const = 0;
+
+    virtual json::object get_ocr_session_pool_stats() const = 0;
 };
 
 struct MaaController : public IMaaEventDispatcher
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include <meojson/json.hpp>
@@ -28,6 +29,17 @@ public:
 
     virtual bool screencap(/*out*/ cv::Mat& image) = 0;
 
+    // 只截 roi 区域（原始分辨率坐标），返回的 image 尺寸应与 roi 一致
+    // 不支持在源头裁剪的控制器保持默认实现，由上层退回整帧截图
+    virtual bool support_screencap_region() const { return false; }
+
+    virtual bool screencap_region(const cv::Rect& roi, /*out*/ cv::Mat& image)
+    {
+        std::ignore = roi;
+        std::ignore = image;
+        return false;
+    }
+
     virtual bool click(int x, int y) = 0;
     virtual bool swipe(int x1, int y1, int x2, int y2, int duration) = 0;
 
@@ -1115,6 +1115,22 @@ struct ResourceGetDefaultActionParamReverseResponse
     MEO_JSONIZATION(has_value, param, _ResourceGetDefaultActionParamReverseResponse);
 };
 
+struct ResourceGetOCRSessionPoolStatsReverseRequest
+{
+    std::string resource_id;
+
+    MessageTypePlaceholder _ResourceGetOCRSessionPoolStatsReverseRequest = 1;
+    MEO_JSONIZATION(resource_id, _ResourceGetOCRSessionPoolStatsReverseRequest);
+};
+
+struct ResourceGetOCRSessionPoolStatsReverseResponse
+{
+    json::object stats;
+
+    MessageTypePlaceholder _ResourceGetOCRSessionPoolStatsReverseResponse = 1;
+    MEO_JSONIZATION(stats, _ResourceGetOCRSessionPoolStatsReverseResponse);
+};
+
 struct ControllerPostConnectionReverseRequest
 {
     std::string controller_id;
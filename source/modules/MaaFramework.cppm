@@ -64,6 +64,7 @@ export constexpr auto _MaaAdbScreencapMethod_RawByNetcat = MaaAdbScreencapMethod
 export constexpr auto _MaaAdbScreencapMethod_MinicapDirect = MaaAdbScreencapMethod_MinicapDirect;
 export constexpr auto _MaaAdbScreencapMethod_MinicapStream = MaaAdbScreencapMethod_MinicapStream;
 export constexpr auto _MaaAdbScreencapMethod_EmulatorExtras = MaaAdbScreencapMethod_EmulatorExtras;
+export constexpr auto _MaaAdbScreencapMethod_RawStream = MaaAdbScreencapMethod_RawStream;
 export constexpr auto _MaaAdbScreencapMethod_None = MaaAdbScreencapMethod_None;
 export constexpr auto _MaaAdbScreencapMethod_All = MaaAdbScreencapMethod_All;
 export constexpr auto _MaaAdbScreencapMethod_Default = MaaAdbScreencapMethod_Default;
@@ -223,6 +224,7 @@ export using ::MaaResourceGetCustomRecognitionList;
 export using ::MaaResourceGetCustomActionList;
 export using ::MaaResourceGetDefaultRecognitionParam;
 export using ::MaaResourceGetDefaultActionParam;
+export using ::MaaResourceGetOCRSessionPoolStats;
 
 // Instance/MaaTasker.h
 
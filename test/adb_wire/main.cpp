@@ -0,0 +1,241 @@
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "General/AdbWireClient.h"
+#include "MaaUtils/IOStream/SockIOStream.h"
+
+using namespace std::chrono_literals;
+using MAA_CTRL_UNIT_NS::AdbWireClient;
+using MAA_NS::ClientSockIOFactory;
+using MAA_NS::ServerSockIOFactory;
+using MAA_NS::SockIOStream;
+
+namespace
+{
+
+// 假的 adb server：按 smart socket 协议读请求，按请求内容给出预设的回应
+// 设备 "device"：支持 shell v2；"legacy"：拒绝 shell v2，features 里也没有，只能走 exec:；其他序列号一律 FAIL
+class FakeAdbServer
+{
+public:
+    FakeAdbServer()
+        : factory_("127.0.0.1", 0)
+        , thread_([this]() { serve(); })
+    {
+    }
+
+    ~FakeAdbServer()
+    {
+        stopping_ = true;
+        // accept 还阻塞着，连一下让它返回
+        ClientSockIOFactory("127.0.0.1", port()).connect();
+        thread_.join();
+    }
+
+    FakeAdbServer(const FakeAdbServer&) = delete;
+    FakeAdbServer& operator=(const FakeAdbServer&) = delete;
+
+    uint16_t port() { return factory_.port(); }
+
+private:
+    void serve()
+    {
+        while (!stopping_) {
+            auto ios = factory_.accept();
+            if (!ios || stopping_) {
+                break;
+            }
+            handle(*ios);
+            ios->release();
+        }
+    }
+
+    static std::optional<std::string> read_exact(SockIOStream& ios, size_t count)
+    {
+        std::string result;
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (result.size() < count) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return std::nullopt;
+            }
+            std::string chunk = ios.read_some(count - result.size(), std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+            if (chunk.empty()) {
+                return std::nullopt;
+            }
+            result.append(chunk);
+        }
+        return result;
+    }
+
+    static std::optional<std::string> read_request(SockIOStream& ios)
+    {
+        auto length_hex = read_exact(ios, 4);
+        if (!length_hex) {
+            return std::nullopt;
+        }
+        return read_exact(ios, std::stoul(*length_hex, nullptr, 16));
+    }
+
+    static void okay(SockIOStream& ios, std::optional<std::string> payload = std::nullopt)
+    {
+        ios.write(payload ? std::format("OKAY{:04x}{}", payload->size(), *payload) : std::string("OKAY"));
+    }
+
+    static void fail(SockIOStream& ios, const std::string& message)
+    {
+        ios.write(std::format("FAIL{:04x}{}", message.size(), message));
+    }
+
+    static std::string shell_packet(char id, const std::string& data)
+    {
+        const auto size = static_cast<uint32_t>(data.size());
+        std::string packet { id,
+                             static_cast<char>(size & 0xff),
+                             static_cast<char>((size >> 8) & 0xff),
+                             static_cast<char>((size >> 16) & 0xff),
+                             static_cast<char>((size >> 24) & 0xff) };
+        return packet + data;
+    }
+
+    void handle(SockIOStream& ios)
+    {
+        std::string serial;
+
+        while (auto request = read_request(ios)) {
+            if (request->starts_with("host:transport:")) {
+                serial = request->substr(std::string_view("host:transport:").size());
+                if (serial != "device" && serial != "legacy") {
+                    fail(ios, "device '" + serial + "' not found");
+                    return;
+                }
+                okay(ios);
+                continue;
+            }
+
+            if (*request == "host-serial:device:get-state") {
+                okay(ios, "device");
+                return;
+            }
+            if (*request == "host-serial:device:features") {
+                okay(ios, "shell_v2,cmd");
+                return;
+            }
+            if (*request == "host-serial:legacy:features") {
+                okay(ios, "cmd");
+                return;
+            }
+
+            if (request->starts_with("shell,v2,raw:")) {
+                if (serial != "device") {
+                    fail(ios, "unknown service");
+                    return;
+                }
+                okay(ios);
+                // 客户端先关 stdin
+                if (read_exact(ios, 5) != shell_packet(4, "")) {
+                    return;
+                }
+
+                std::string cmd = request->substr(std::string_view("shell,v2,raw:").size());
+                if (cmd == "echo ok") {
+                    ios.write(shell_packet(1, "ok\n") + shell_packet(2, "warning\n") + shell_packet(3, std::string(1, '\0')));
+                }
+                else if (cmd == "false") {
+                    ios.write(shell_packet(3, std::string(1, '\1')));
+                }
+                return;
+            }
+
+            if (request->starts_with("exec:")) {
+                okay(ios);
+                std::string cmd = request->substr(std::string_view("exec:").size());
+                if (cmd == "echo ok") {
+                    ios.write("ok\n");
+                }
+                else if (cmd == "stall") {
+                    // 只给一半就卡住，客户端应当按超时失败处理，而不是把截断的输出当结果
+                    ios.write("partial");
+                    std::this_thread::sleep_for(1s);
+                }
+                return;
+            }
+
+            fail(ios, "unknown request");
+            return;
+        }
+    }
+
+    ServerSockIOFactory factory_;
+    std::atomic_bool stopping_ = false;
+    std::thread thread_;
+};
+
+using ShellResult = std::optional<std::optional<std::string>>;
+
+bool expect(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cout << "AdbWireTesting failed: " << what << std::endl;
+    }
+    return condition;
+}
+
+std::string describe(const ShellResult& result)
+{
+    if (!result) {
+        return "not executed";
+    }
+    if (!*result) {
+        return "failed";
+    }
+    return "output: " + **result;
+}
+
+} // namespace
+
+int main()
+{
+    FakeAdbServer server;
+
+    AdbWireClient device("device", server.port());
+    AdbWireClient legacy("legacy", server.port());
+    AdbWireClient missing("missing", server.port());
+
+    bool ret = true;
+
+    // OKAY 后跟长度前缀的应答
+    auto state = device.get_state();
+    ret &= expect(state == "device", std::format("get_state: {}", state.value_or("nullopt")));
+
+    // shell v2：stdout 拼起来，stderr 不混进输出，退出码 0 才算成功
+    auto ok = device.shell("echo ok", 2s);
+    ret &= expect(ok && *ok == "ok\n", "shell v2 echo ok, " + describe(ok));
+
+    // 命令执行了但退出码非 0：外层有值（不能回退重跑），内层为空
+    auto failed = device.shell("false", 2s);
+    ret &= expect(failed && !*failed, "shell v2 exit code 1, " + describe(failed));
+
+    // transport 被 FAIL：命令没交给设备，外层为空，调用方可以安全回退
+    auto not_found = missing.shell("echo ok", 2s);
+    ret &= expect(!not_found, "transport FAIL, " + describe(not_found));
+
+    // shell v2 被拒绝且 features 里没有 shell_v2：改走 exec:
+    auto exec_ok = legacy.shell("echo ok", 2s);
+    ret &= expect(exec_ok && *exec_ok == "ok\n", "exec fallback, " + describe(exec_ok));
+
+    // exec: 到超时对端还没关，输出不完整，按失败处理
+    auto truncated = legacy.shell("stall", 300ms);
+    ret &= expect(truncated && !*truncated, "exec truncation, " + describe(truncated));
+
+    if (ret) {
+        std::cout << "AdbWireTesting passed" << std::endl;
+    }
+    return ret ? 0 : -1;
+}
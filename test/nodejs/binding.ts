@@ -90,7 +90,9 @@ async function api_test() {
     r2.inference_execution_provider = 'DirectML'
     r2.inference_device = 114514
     r2.inference_execution_provider = 'CPU'
+    r2.ocr_session_pool_size = 4
     await r2.post_bundle('/path/to/resource').wait()
+    console.log('r2 ocr_session_pool_stats', r2.ocr_session_pool_stats)
     r2.destroy()
 
     const resource = new maa.Resource()
@@ -1,7 +1,12 @@
 #include <filesystem>
 
+#include "module/ParallelNextList.h"
 #include "module/PipelineSmoking.h"
+#include "module/PyramidMatch.h"
+#include "module/RegionReuse.h"
+#include "module/RegionScreencap.h"
 #include "module/RunWithoutFile.h"
+#include "module/TemplateMatchCompare.h"
 
 #include "MaaFramework/MaaAPI.h"
 
@@ -26,6 +31,24 @@ int main([[maybe_unused]] int argc, char** argv)
     if (!pipeline_smoking(testset_dir)) {
         return -1;
     }
+    if (!parallel_next_list(testset_dir)) {
+        return -1;
+    }
+    if (!region_screencap(testset_dir)) {
+        return -1;
+    }
+    if (!region_reuse(testset_dir)) {
+        return -1;
+    }
+    if (!pyramid_match(testset_dir)) {
+        return -1;
+    }
+    if (!template_match_compare(testset_dir)) {
+        return -1;
+    }
+    if (!template_match_bench(testset_dir)) {
+        return -1;
+    }
 
     return 0;
 }
@@ -0,0 +1,182 @@
+#include "ParallelNextList.h"
+
+#include <algorithm>
+#include <iostream>
+#include <tuple>
+
+#include <opencv2/core.hpp>
+
+#include "TestingUtils.h"
+
+namespace
+{
+
+struct ListRun
+{
+    std::string hit;
+    std::vector<json::value> records;
+    std::vector<MaaRecoId> committed_ids;
+};
+
+// 纹理随机的整图，颜色上限 200，纯品红永远匹配不到
+cv::Mat make_frame()
+{
+    cv::Mat frame(720, 1280, CV_8UC3);
+    cv::RNG rng(20240607);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(200));
+    return frame;
+}
+
+json::value make_pipeline()
+{
+    const json::value miss_color {
+        { "recognition", "ColorMatch" },
+        { "lower", json::array { 255, 0, 255 } },
+        { "upper", json::array { 255, 0, 255 } },
+    };
+    const json::value template_full {
+        { "recognition", "TemplateMatch" },
+        { "template", "ParallelNextList/target.png" },
+        { "threshold", 0.95 },
+    };
+    const json::value template_corner {
+        { "recognition", "TemplateMatch" },
+        { "template", "ParallelNextList/target.png" },
+        { "threshold", 0.95 },
+        { "roi", json::array { 0, 0, 200, 200 } },
+    };
+
+    auto as_sub = [](const json::value& reco, const std::string& sub_name) {
+        json::value sub = reco;
+        sub["sub_name"] = sub_name;
+        return sub;
+    };
+
+    return json::object {
+        { "ParallelEntry",
+          json::object {
+              { "next", json::array { "MissColor", "MissAnd", "HitOr", "HitTemplate", "LaterColor" } },
+              { "timeout", 3000 },
+          } },
+        { "MissColor", miss_color },
+        // 第一个子识别命中、第二个不中，子识别结果也要和父识别一起提交
+        { "MissAnd",
+          json::object {
+              { "recognition", "And" },
+              { "all_of", json::array { as_sub(template_full, "AndTemplate"), as_sub(template_corner, "AndCorner") } },
+          } },
+        { "HitOr",
+          json::object {
+              { "recognition", "Or" },
+              { "any_of", json::array { as_sub(miss_color, "OrColor"), as_sub(template_full, "OrTemplate") } },
+          } },
+        // 并行时这两个可能也跑完了，但排在命中节点之后，结果不能进 RuntimeCache
+        { "HitTemplate", template_full },
+        { "LaterColor",
+          json::object {
+              { "recognition", "And" },
+              { "all_of", json::array { as_sub(template_full, "LaterTemplate"), as_sub(miss_color, "LaterColor") } },
+          } },
+    };
+}
+
+std::optional<ListRun> run_list(MaaTasker* tasker, RecoRecorder& recorder, bool parallel)
+{
+    MaaGlobalSetOption(MaaGlobalOption_ParallelNextList, &parallel, sizeof(parallel));
+    recorder.clear();
+
+    std::string pipeline_str = make_pipeline().to_string();
+    MaaTaskId task_id = MaaTaskerPostTask(tasker, "ParallelEntry", pipeline_str.c_str());
+    MaaStatus status = MaaTaskerWait(tasker, task_id);
+
+    bool off = false;
+    MaaGlobalSetOption(MaaGlobalOption_ParallelNextList, &off, sizeof(off));
+
+    if (status != MaaStatus_Succeeded) {
+        std::cout << "ParallelEntry failed, parallel: " << parallel << std::endl;
+        return std::nullopt;
+    }
+
+    ListRun run;
+    for (const auto& record : recorder.records()) {
+        if (record.contains("box") && !record.at("box").is_null()) {
+            run.hit = record.at("name").as_string();
+        }
+        collect_reco_ids(record, run.committed_ids);
+        run.records.emplace_back(strip_reco_ids(record));
+    }
+    return run;
+}
+
+// 本次任务产生的 reco_id 里，能查到详情的必须恰好是回调里出现过的（含子识别）
+bool check_committed(const MaaTasker* tasker, const ListRun& run)
+{
+    if (run.committed_ids.empty()) {
+        std::cout << "no reco id recorded" << std::endl;
+        return false;
+    }
+
+    auto [min_iter, max_iter] = std::ranges::minmax_element(run.committed_ids);
+    // 被丢弃的候选可能排在最后一个提交的 id 之后，多往后查一段
+    constexpr MaaRecoId kTail = 64;
+    for (MaaRecoId id = *min_iter; id <= *max_iter + kTail; ++id) {
+        bool committed = std::ranges::find(run.committed_ids, id) != run.committed_ids.end();
+        bool recorded = get_reco_detail(tasker, id).has_value();
+        if (committed != recorded) {
+            std::cout << "unexpected runtime cache entry, reco_id: " << id << ", committed: " << committed
+                      << ", recorded: " << recorded << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool parallel_next_list(const std::filesystem::path& testset_dir)
+{
+    std::ignore = testset_dir;
+
+    cv::Mat frame = make_frame();
+    cv::Mat target = frame(cv::Rect(600, 400, 96, 64)).clone();
+
+    FrameSequenceController controller({ frame });
+
+    auto* resource_handle = MaaResourceCreate();
+    auto* target_buffer = MaaImageBufferCreate();
+    set_image(target_buffer, target);
+    MaaResourceOverrideImage(resource_handle, "ParallelNextList/target.png", target_buffer);
+    MaaImageBufferDestroy(target_buffer);
+
+    auto* tasker_handle = MaaTaskerCreate();
+    MaaTaskerBindResource(tasker_handle, resource_handle);
+    MaaTaskerBindController(tasker_handle, controller.handle());
+
+    bool ret = false;
+    {
+        RecoRecorder recorder(tasker_handle);
+
+        auto sequential = run_list(tasker_handle, recorder, false);
+        auto parallel = run_list(tasker_handle, recorder, true);
+
+        if (!sequential || !parallel) {
+            // already logged
+        }
+        else if (sequential->hit != "HitOr" || parallel->hit != sequential->hit) {
+            std::cout << "hit mismatch, sequential: " << sequential->hit << ", parallel: " << parallel->hit << std::endl;
+        }
+        else if (json::array(parallel->records) != json::array(sequential->records)) {
+            std::cout << "reco details mismatch" << std::endl
+                      << "sequential: " << json::array(sequential->records).to_string() << std::endl
+                      << "parallel: " << json::array(parallel->records).to_string() << std::endl;
+        }
+        else {
+            ret = check_committed(tasker_handle, *parallel);
+        }
+    }
+
+    MaaTaskerDestroy(tasker_handle);
+    MaaResourceDestroy(resource_handle);
+
+    return ret;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <filesystem>
+
+bool parallel_next_list(const std::filesystem::path& testset_dir);
@@ -0,0 +1,107 @@
+#include "PyramidMatch.h"
+
+#include <iostream>
+
+#include "TestingUtils.h"
+
+namespace
+{
+
+constexpr int kPyramid = 2;
+const cv::Size kTemplSize(64, 48);
+
+std::optional<json::object> match(MaaTasker* tasker, const cv::Mat& image, int pyramid)
+{
+    const json::value param {
+        { "template", "PyramidMatch/target.png" },
+        { "threshold", 0.9 },
+        { "order_by", "Score" },
+        { "pyramid", pyramid },
+    };
+    return run_direct_recognition(tasker, "TemplateMatch", param, image);
+}
+
+bool contains_box(const json::value& results, const json::value& box)
+{
+    if (!results.is_array()) {
+        return false;
+    }
+    for (const auto& res : results.as_array()) {
+        if (res.contains("box") && res.at("box") == box) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+// 从截图上裁下模板，pyramid 0 和 N 都必须在原位置命中，且 N 的结果必须是 0 的结果之一
+bool pyramid_match(const std::filesystem::path& testset_dir)
+{
+    auto screenshots = load_screenshots(testset_dir);
+    if (screenshots.empty()) {
+        std::cout << "no screenshot" << std::endl;
+        return false;
+    }
+
+    auto* resource_handle = MaaResourceCreate();
+    auto* tasker_handle = MaaTaskerCreate();
+    MaaTaskerBindResource(tasker_handle, resource_handle);
+
+    bool ret = true;
+    size_t checked = 0;
+    for (size_t i = 0; i < screenshots.size() && ret; ++i) {
+        const cv::Mat& image = screenshots.at(i);
+        const std::vector<cv::Point> origins {
+            { image.cols / 4, image.rows / 4 },
+            { image.cols / 2, image.rows / 2 },
+            { image.cols * 3 / 4 - kTemplSize.width, image.rows * 3 / 4 - kTemplSize.height },
+        };
+
+        for (const cv::Point& origin : origins) {
+            const cv::Rect rect(origin, kTemplSize);
+            if ((rect & cv::Rect(0, 0, image.cols, image.rows)) != rect || !textured(image(rect))) {
+                continue;
+            }
+
+            auto* templ_buffer = MaaImageBufferCreate();
+            cv::Mat templ = image(rect).clone();
+            set_image(templ_buffer, templ);
+            MaaResourceOverrideImage(resource_handle, "PyramidMatch/target.png", templ_buffer);
+            MaaImageBufferDestroy(templ_buffer);
+
+            auto full = match(tasker_handle, image, 0);
+            auto coarse = match(tasker_handle, image, kPyramid);
+            const json::value expected_box = json::array { rect.x, rect.y, rect.width, rect.height };
+
+            if (!full || !coarse || !full->at("hit").as_boolean() || !coarse->at("hit").as_boolean()) {
+                std::cout << "pyramid miss, image: " << i << ", rect: " << expected_box.to_string() << std::endl;
+                ret = false;
+                break;
+            }
+
+            const json::value& full_filtered = full->at("detail").get("filtered", json::value { });
+            const json::value& coarse_filtered = coarse->at("detail").get("filtered", json::value { });
+            if (!contains_box(full_filtered, expected_box) || !contains_box(coarse_filtered, expected_box)
+                || !contains_box(full_filtered, coarse->at("box"))) {
+                std::cout << "pyramid result mismatch, image: " << i << ", rect: " << expected_box.to_string() << std::endl
+                          << "pyramid 0: " << full->at("detail").to_string() << std::endl
+                          << "pyramid " << kPyramid << ": " << coarse->at("detail").to_string() << std::endl;
+                ret = false;
+                break;
+            }
+            ++checked;
+        }
+    }
+
+    if (ret && checked == 0) {
+        std::cout << "no textured crop to check" << std::endl;
+        ret = false;
+    }
+
+    MaaTaskerDestroy(tasker_handle);
+    MaaResourceDestroy(resource_handle);
+
+    return ret;
+}
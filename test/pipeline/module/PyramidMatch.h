@@ -0,0 +1,5 @@
+#pragma once
+
+#include <filesystem>
+
+bool pyramid_match(const std::filesystem::path& testset_dir);
@@ -0,0 +1,287 @@
+#include "RegionReuse.h"
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "TestingUtils.h"
+
+namespace
+{
+
+// tile 为 32x32。ROI 从 tile 中间开始，跨过 x=32、y=32 两条 tile 边界，右边和下边正好贴着 tile 边界
+const cv::Rect kRoi(20, 20, 44, 44);
+constexpr int kSentinelSize = 16;
+
+struct ReuseCase
+{
+    std::string desc;
+    cv::Point marker;
+    bool expect_reuse = false;
+};
+
+// 右下角的像素还在 ROI 内，必须重新识别；右边、下边紧挨着的像素已经在下一个 tile，节点应当复用上一轮结果
+// 左边紧挨着的像素和 ROI 同在一个 tile，按 tile 比较会重新识别，结果也不能变
+const std::vector<ReuseCase> kCases {
+    { "just inside", { 63, 63 }, false },
+    { "just outside right", { 64, 63 }, true },
+    { "just outside bottom", { 63, 64 }, true },
+    { "just outside left", { 19, 40 }, false },
+};
+
+// 颜色上下限 16 和 200，纯红、纯绿永远匹配不到
+cv::Mat make_frame()
+{
+    cv::Mat frame(720, 1280, CV_8UC3);
+    cv::RNG rng(20240615);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(16), cv::Scalar::all(200));
+    return frame;
+}
+
+cv::Rect sentinel_rect(const cv::Size& size)
+{
+    return { size.width - kSentinelSize, size.height - kSentinelSize, kSentinelSize, kSentinelSize };
+}
+
+cv::Mat with_marker(const cv::Mat& base, const cv::Point& marker)
+{
+    cv::Mat frame = base.clone();
+    frame.at<cv::Vec3b>(marker) = cv::Vec3b(0, 0, 255);
+    return frame;
+}
+
+// 右下角涂一块纯绿，哨兵节点命中后 next 列表结束
+cv::Mat with_sentinel(const cv::Mat& base)
+{
+    cv::Mat frame = base.clone();
+    frame(sentinel_rect(frame.size())).setTo(cv::Scalar(0, 255, 0));
+    return frame;
+}
+
+json::value make_pipeline(const std::string& reco_type, const json::value& reco_param, const cv::Size& size)
+{
+    json::value target = reco_param;
+    target["recognition"] = reco_type;
+
+    const cv::Rect sentinel = sentinel_rect(size);
+
+    return json::object {
+        { "ReuseEntry",
+          json::object {
+              { "next", json::array { "ReuseTarget", "ReuseSentinel" } },
+              { "rate_limit", 0 },
+              { "timeout", 5000 },
+          } },
+        { "ReuseTarget", target },
+        { "ReuseSentinel",
+          json::object {
+              { "recognition", "ColorMatch" },
+              { "lower", json::array { 0, 255, 0 } },
+              { "upper", json::array { 0, 255, 0 } },
+              { "roi", json::array { sentinel.x, sentinel.y, sentinel.width, sentinel.height } },
+              { "count", kSentinelSize * kSentinelSize },
+          } },
+    };
+}
+
+// 识别时画的调试图，底图就是识别用的那一帧。复用的结果带的是上一帧的图
+std::vector<cv::Mat> get_reco_draws(const MaaTasker* tasker, MaaRecoId reco_id)
+{
+    auto* draws = MaaImageListBufferCreate();
+
+    std::vector<cv::Mat> result;
+    if (MaaTaskerGetRecognitionDetail(tasker, reco_id, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, draws)) {
+        for (MaaSize i = 0; i < MaaImageListBufferSize(draws); ++i) {
+            const auto* draw = MaaImageListBufferAt(draws, i);
+            cv::Mat image(MaaImageBufferHeight(draw), MaaImageBufferWidth(draw), MaaImageBufferType(draw), MaaImageBufferGetRawData(draw));
+            result.emplace_back(image.clone());
+        }
+    }
+
+    MaaImageListBufferDestroy(draws);
+    return result;
+}
+
+bool same_draws(const std::vector<cv::Mat>& lhs, const std::vector<cv::Mat>& rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].size() != rhs[i].size() || lhs[i].type() != rhs[i].type() || cv::norm(lhs[i], rhs[i], cv::NORM_INF) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+json::value comparable(const json::object& detail)
+{
+    return json::object {
+        { "hit", detail.at("hit") },
+        { "box", detail.at("box") },
+        { "detail", detail.at("detail") },
+    };
+}
+
+// 前两帧是原图（入口节点可能用掉一帧），第三帧改一个像素，第四帧再加上哨兵
+// ReuseTarget 的第一条记录对应原图，第二条对应改过像素的图
+bool check_case(
+    MaaTasker* tasker,
+    FrameSequenceController& controller,
+    RecoRecorder& recorder,
+    const std::string& reco_type,
+    const json::value& reco_param,
+    const cv::Mat& base,
+    const ReuseCase& reuse_case,
+    std::optional<bool> expect_hit)
+{
+    const std::string prefix = reco_type + " " + reuse_case.desc + ": ";
+
+    cv::Mat modified = with_marker(base, reuse_case.marker);
+    controller.reset({ base, base, modified, with_sentinel(modified) });
+    recorder.clear();
+
+    std::string pipeline_str = make_pipeline(reco_type, reco_param, base.size()).to_string();
+    MaaTaskId task_id = MaaTaskerPostTask(tasker, "ReuseEntry", pipeline_str.c_str());
+    if (MaaTaskerWait(tasker, task_id) != MaaStatus_Succeeded) {
+        std::cout << prefix << "ReuseEntry failed" << std::endl;
+        return false;
+    }
+
+    std::vector<MaaRecoId> target_ids;
+    for (const auto& record : recorder.records()) {
+        if (record.get("name", std::string()) == "ReuseTarget") {
+            target_ids.emplace_back(record.at("reco_id").as<MaaRecoId>());
+        }
+    }
+    if (target_ids.size() < 2) {
+        std::cout << prefix << "ReuseTarget recognized " << target_ids.size() << " times" << std::endl;
+        return false;
+    }
+
+    auto base_draws = get_reco_draws(tasker, target_ids[0]);
+    auto modified_draws = get_reco_draws(tasker, target_ids[1]);
+    if (base_draws.empty()) {
+        std::cout << prefix << "no draws recorded" << std::endl;
+        return false;
+    }
+    bool reused = same_draws(base_draws, modified_draws);
+    if (reused != reuse_case.expect_reuse) {
+        std::cout << prefix << "reused: " << reused << ", expected: " << reuse_case.expect_reuse << std::endl;
+        return false;
+    }
+
+    // 复用也好、重新识别也好，结果都必须和对这一帧直接识别一致
+    auto actual = get_reco_detail(tasker, target_ids[1]);
+    auto expected = run_direct_recognition(tasker, reco_type, reco_param, modified);
+    if (!actual || !expected) {
+        std::cout << prefix << "reco detail missing" << std::endl;
+        return false;
+    }
+    if (comparable(*actual) != comparable(*expected)) {
+        std::cout << prefix << "detail mismatch" << std::endl
+                  << "pipeline: " << comparable(*actual).to_string() << std::endl
+                  << "direct: " << comparable(*expected).to_string() << std::endl;
+        return false;
+    }
+    if (expect_hit && actual->at("hit").as_boolean() != *expect_hit) {
+        std::cout << prefix << "hit: " << actual->at("hit").as_boolean() << ", expected: " << *expect_hit << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<std::string> find_classify_model(const std::filesystem::path& resource_dir)
+{
+    auto model_dir = resource_dir / "model" / "classify";
+    if (!std::filesystem::exists(model_dir)) {
+        return std::nullopt;
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(model_dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".onnx") {
+            return entry.path().filename().string();
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+bool region_reuse(const std::filesystem::path& testset_dir)
+{
+    auto resource_dir = testset_dir / "PipelineSmoking" / "resource";
+    auto* resource_handle = MaaResourceCreate();
+    MaaResourceWait(resource_handle, MaaResourcePostBundle(resource_handle, resource_dir.string().c_str()));
+
+    FrameSequenceController controller(std::vector<cv::Mat> { });
+
+    auto* tasker_handle = MaaTaskerCreate();
+    MaaTaskerBindResource(tasker_handle, resource_handle);
+    MaaTaskerBindController(tasker_handle, controller.handle());
+
+    const json::array roi { kRoi.x, kRoi.y, kRoi.width, kRoi.height };
+
+    bool ret = true;
+    {
+        RecoRecorder recorder(tasker_handle);
+
+        auto run_cases = [&](const std::string& reco_type, const json::value& reco_param, const cv::Mat& base, bool check_hit) {
+            for (const auto& reuse_case : kCases) {
+                std::optional<bool> expect_hit = check_hit ? std::make_optional(kRoi.contains(reuse_case.marker)) : std::nullopt;
+                if (!check_case(tasker_handle, controller, recorder, reco_type, reco_param, base, reuse_case, expect_hit)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // ColorMatch 只找一个纯红像素，命中与否直接说明看到的是不是新的一帧
+        const json::value color_param {
+            { "lower", json::array { 255, 0, 0 } },
+            { "upper", json::array { 255, 0, 0 } },
+            { "roi", roi },
+            { "count", 1 },
+        };
+        ret = run_cases("ColorMatch", color_param, make_frame(), true);
+
+        // OCR only_rec 和神经网络用真实截图，模型不在测试资源里时跳过
+        auto screenshots = load_screenshots(testset_dir);
+        if (ret && screenshots.empty()) {
+            std::cout << "no screenshot loaded" << std::endl;
+            ret = false;
+        }
+
+        if (ret && std::filesystem::exists(resource_dir / "model" / "ocr" / "rec.onnx")) {
+            const json::value ocr_param {
+                { "only_rec", true },
+                { "roi", roi },
+            };
+            ret = run_cases("OCR", ocr_param, screenshots.front(), false);
+        }
+        else if (ret) {
+            std::cout << "OCR model not found, skip" << std::endl;
+        }
+
+        auto classify_model = find_classify_model(resource_dir);
+        if (ret && classify_model) {
+            const json::value nn_param {
+                { "model", *classify_model },
+                { "roi", roi },
+            };
+            ret = run_cases("NeuralNetworkClassify", nn_param, screenshots.front(), false);
+        }
+        else if (ret) {
+            std::cout << "classify model not found, skip" << std::endl;
+        }
+    }
+
+    MaaTaskerDestroy(tasker_handle);
+    MaaResourceDestroy(resource_handle);
+
+    return ret;
+}
@@ -0,0 +1,148 @@
+#include "RegionScreencap.h"
+
+#include <iostream>
+#include <tuple>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "TestingUtils.h"
+
+namespace
+{
+
+const cv::Rect kTargetRect(600, 400, 96, 64);
+
+// 颜色下限 16，区域截图补的黑边不会和画面本身混淆；上限 200，纯品红永远匹配不到
+cv::Mat make_frame()
+{
+    cv::Mat frame(720, 1280, CV_8UC3);
+    cv::RNG rng(20240611);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(16), cv::Scalar::all(200));
+    return frame;
+}
+
+const json::value& hit_param()
+{
+    static const json::value param {
+        { "template", "RegionScreencap/target.png" },
+        { "threshold", 0.95 },
+        { "roi", json::array { 560, 360, 200, 150 } },
+    };
+    return param;
+}
+
+json::value make_pipeline()
+{
+    json::value region_hit = hit_param();
+    region_hit["recognition"] = "TemplateMatch";
+
+    return json::object {
+        // 入口节点看整屏，截的是整图；之后的 next 列表只看固定区域，走区域截图
+        { "RegionEntry",
+          json::object {
+              { "next", json::array { "RegionMiss", "RegionHit" } },
+          } },
+        { "RegionMiss",
+          json::object {
+              { "recognition", "ColorMatch" },
+              { "lower", json::array { 255, 0, 255 } },
+              { "upper", json::array { 255, 0, 255 } },
+              { "roi", json::array { 500, 300, 80, 80 } },
+          } },
+        { "RegionHit", region_hit },
+    };
+}
+
+int64_t region_screencap_count(const MaaController* controller)
+{
+    auto* buffer = MaaStringBufferCreate();
+    int64_t count = -1;
+    if (MaaControllerGetInfo(controller, buffer)) {
+        auto info = json::parse(MaaStringBufferGet(buffer)).value_or(json::value { });
+        count = info.get("region_screencap_count", int64_t(-1));
+    }
+    MaaStringBufferDestroy(buffer);
+    return count;
+}
+
+} // namespace
+
+bool region_screencap(const std::filesystem::path& testset_dir)
+{
+    std::ignore = testset_dir;
+
+    cv::Mat frame = make_frame();
+
+    auto image_dir = std::filesystem::temp_directory_path() / "MaaRegionScreencap";
+    std::filesystem::remove_all(image_dir);
+    std::filesystem::create_directories(image_dir);
+    if (!cv::imwrite((image_dir / "frame.png").string(), frame)) {
+        std::cout << "failed to write frame" << std::endl;
+        return false;
+    }
+
+    auto* controller_handle =
+        MaaDbgControllerCreate(image_dir.string().c_str(), image_dir.string().c_str(), MaaDbgControllerType_CarouselImage, "{}");
+    MaaControllerWait(controller_handle, MaaControllerPostConnection(controller_handle));
+
+    auto* resource_handle = MaaResourceCreate();
+    auto* target_buffer = MaaImageBufferCreate();
+    cv::Mat target = frame(kTargetRect).clone();
+    set_image(target_buffer, target);
+    MaaResourceOverrideImage(resource_handle, "RegionScreencap/target.png", target_buffer);
+    MaaImageBufferDestroy(target_buffer);
+
+    auto* tasker_handle = MaaTaskerCreate();
+    MaaTaskerBindResource(tasker_handle, resource_handle);
+    MaaTaskerBindController(tasker_handle, controller_handle);
+
+    bool ret = false;
+    {
+        RecoRecorder recorder(tasker_handle);
+
+        std::string pipeline_str = make_pipeline().to_string();
+        MaaTaskId task_id = MaaTaskerPostTask(tasker_handle, "RegionEntry", pipeline_str.c_str());
+        MaaStatus status = MaaTaskerWait(tasker_handle, task_id);
+
+        std::optional<json::value> region_hit;
+        for (const auto& record : recorder.records()) {
+            if (record.get("name", std::string()) == "RegionHit") {
+                region_hit = record;
+            }
+        }
+
+        // 同一张图整图直接识别，作为参照
+        auto expected = run_direct_recognition(tasker_handle, "TemplateMatch", hit_param(), frame);
+        const json::value expected_box = json::array { kTargetRect.x, kTargetRect.y, kTargetRect.width, kTargetRect.height };
+
+        if (status != MaaStatus_Succeeded) {
+            std::cout << "RegionEntry failed" << std::endl;
+        }
+        else if (region_screencap_count(controller_handle) <= 0) {
+            std::cout << "region screencap not used" << std::endl;
+        }
+        else if (!region_hit || !expected) {
+            std::cout << "RegionHit or reference result missing" << std::endl;
+        }
+        else if (region_hit->at("box") != expected_box || expected->at("box") != expected_box) {
+            std::cout << "box mismatch, region: " << region_hit->at("box").to_string() << ", full: " << expected->at("box").to_string()
+                      << std::endl;
+        }
+        else if (region_hit->at("detail") != expected->at("detail")) {
+            std::cout << "detail mismatch" << std::endl
+                      << "region: " << region_hit->at("detail").to_string() << std::endl
+                      << "full: " << expected->at("detail").to_string() << std::endl;
+        }
+        else {
+            ret = true;
+        }
+    }
+
+    MaaTaskerDestroy(tasker_handle);
+    MaaResourceDestroy(resource_handle);
+    MaaControllerDestroy(controller_handle);
+    std::filesystem::remove_all(image_dir);
+
+    return ret;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <filesystem>
+
+bool region_screencap(const std::filesystem::path& testset_dir);
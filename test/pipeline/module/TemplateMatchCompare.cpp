@@ -0,0 +1,294 @@
+#include "TemplateMatchCompare.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <tuple>
+
+#include <opencv2/imgproc.hpp>
+
+#include "TestingUtils.h"
+
+namespace
+{
+
+constexpr double kThreshold = 0.8;
+const cv::Size kTemplSize(64, 48);
+
+struct RefResult
+{
+    cv::Rect box;
+    float score = 0.0f;
+};
+
+// 参照实现：列优先逐点扫描，不低于 0.5 的点全部进 NMS，一个都没有时取最接近的
+std::vector<RefResult> reference_extract(const cv::Mat& matched, const cv::Size& templ_size)
+{
+    std::vector<RefResult> raw_results;
+    RefResult closest;
+    for (int col = 0; col < matched.cols; ++col) {
+        for (int row = 0; row < matched.rows; ++row) {
+            float score = matched.at<float>(row, col);
+            if (std::isnan(score) || std::isinf(score)) {
+                continue;
+            }
+            cv::Rect box(col, row, templ_size.width, templ_size.height);
+            if (closest.score < score) {
+                closest = RefResult { .box = box, .score = score };
+            }
+            if (score < 0.5f) {
+                continue;
+            }
+            raw_results.emplace_back(RefResult { .box = box, .score = score });
+        }
+    }
+    if (raw_results.empty()) {
+        raw_results.emplace_back(closest);
+    }
+    return raw_results;
+}
+
+// 参照实现：两两比较的 NMS
+std::vector<RefResult> reference_nms(std::vector<RefResult> results, double threshold)
+{
+    std::ranges::sort(results, [](const auto& a, const auto& b) { return a.score > b.score; });
+
+    std::vector<RefResult> nms_results;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& res1 = results[i];
+        if (res1.score < 0.1f) {
+            continue;
+        }
+        auto res1_box = res1.box;
+        nms_results.emplace_back(res1);
+
+        for (size_t j = i + 1; j < results.size(); ++j) {
+            auto& res2 = results[j];
+            if (res2.score < 0.1f) {
+                continue;
+            }
+            int iou_area = (res1_box & res2.box).area();
+            if (iou_area >= threshold * res2.box.area()) {
+                res2.score = 0;
+            }
+        }
+    }
+    return nms_results;
+}
+
+std::vector<RefResult> reference_match(const cv::Mat& image, const cv::Mat& templ)
+{
+    cv::Mat matched;
+    cv::matchTemplate(image, templ, matched, cv::TM_CCOEFF_NORMED, cv::Mat::ones(templ.size(), CV_8UC1));
+    return reference_nms(reference_extract(matched, templ.size()), 0.2);
+}
+
+std::vector<RefResult> from_json(const json::value& results)
+{
+    std::vector<RefResult> converted;
+    if (!results.is_array()) {
+        return converted;
+    }
+    for (const auto& res : results.as_array()) {
+        const auto& box = res.at("box").as_array();
+        converted.emplace_back(
+            RefResult {
+                .box = cv::Rect(box.at(0).as_integer(), box.at(1).as_integer(), box.at(2).as_integer(), box.at(3).as_integer()),
+                .score = static_cast<float>(res.at("score").as_double()),
+            });
+    }
+    return converted;
+}
+
+bool same_results(std::vector<RefResult> lhs, std::vector<RefResult> rhs)
+{
+    auto by_pos = [](const RefResult& a, const RefResult& b) {
+        return a.box.x != b.box.x ? a.box.x < b.box.x : a.box.y < b.box.y;
+    };
+    std::ranges::sort(lhs, by_pos);
+    std::ranges::sort(rhs, by_pos);
+
+    return std::ranges::equal(lhs, rhs, [](const RefResult& a, const RefResult& b) {
+        return a.box == b.box && std::abs(a.score - b.score) < 1e-5f;
+    });
+}
+
+std::string to_string(const std::vector<RefResult>& results)
+{
+    json::array arr;
+    for (const auto& res : results) {
+        arr.emplace_back(
+            json::object {
+                { "box", json::array { res.box.x, res.box.y, res.box.width, res.box.height } },
+                { "score", res.score },
+            });
+    }
+    return arr.to_string();
+}
+
+// 每张截图上取几块纹理足够的区域当模板
+std::vector<cv::Rect> template_rects(const cv::Mat& image)
+{
+    const std::vector<cv::Point> origins {
+        { image.cols / 4, image.rows / 4 },
+        { image.cols / 2, image.rows / 2 },
+        { image.cols * 3 / 4 - kTemplSize.width, image.rows * 3 / 4 - kTemplSize.height },
+    };
+
+    std::vector<cv::Rect> rects;
+    for (const cv::Point& origin : origins) {
+        const cv::Rect rect(origin, kTemplSize);
+        if ((rect & cv::Rect(0, 0, image.cols, image.rows)) == rect && textured(image(rect))) {
+            rects.emplace_back(rect);
+        }
+    }
+    return rects;
+}
+
+struct Fixture
+{
+    Fixture()
+    {
+        resource = MaaResourceCreate();
+        tasker = MaaTaskerCreate();
+        MaaTaskerBindResource(tasker, resource);
+    }
+
+    ~Fixture()
+    {
+        MaaTaskerDestroy(tasker);
+        MaaResourceDestroy(resource);
+    }
+
+    Fixture(const Fixture&) = delete;
+    Fixture& operator=(const Fixture&) = delete;
+
+    void set_template(const cv::Mat& templ)
+    {
+        auto* buffer = MaaImageBufferCreate();
+        set_image(buffer, templ);
+        MaaResourceOverrideImage(resource, "TemplateMatchCompare/target.png", buffer);
+        MaaImageBufferDestroy(buffer);
+    }
+
+    std::optional<json::object> match(const cv::Mat& image)
+    {
+        const json::value param {
+            { "template", "TemplateMatchCompare/target.png" },
+            { "threshold", kThreshold },
+        };
+        return run_direct_recognition(tasker, "TemplateMatch", param, image);
+    }
+
+    MaaResource* resource = nullptr;
+    MaaTasker* tasker = nullptr;
+};
+
+} // namespace
+
+bool template_match_compare(const std::filesystem::path& testset_dir)
+{
+    auto screenshots = load_screenshots(testset_dir);
+    if (screenshots.empty()) {
+        std::cout << "no screenshot" << std::endl;
+        return false;
+    }
+
+    Fixture fixture;
+
+    size_t checked = 0;
+    for (size_t i = 0; i < screenshots.size(); ++i) {
+        const cv::Mat& image = screenshots.at(i);
+        for (const cv::Rect& rect : template_rects(image)) {
+            cv::Mat templ = image(rect).clone();
+            fixture.set_template(templ);
+
+            auto actual = fixture.match(image);
+            if (!actual) {
+                std::cout << "TemplateMatch failed, image: " << i << std::endl;
+                return false;
+            }
+
+            auto expected_all = reference_match(image, templ);
+            std::vector<RefResult> expected_filtered;
+            std::ranges::copy_if(expected_all, std::back_inserter(expected_filtered), [](const RefResult& res) {
+                return kThreshold < res.score;
+            });
+
+            auto actual_all = from_json(actual->at("detail").get("all", json::value { }));
+            auto actual_filtered = from_json(actual->at("detail").get("filtered", json::value { }));
+
+            if (!same_results(actual_all, expected_all) || !same_results(actual_filtered, expected_filtered)) {
+                std::cout << "TemplateMatch results mismatch, image: " << i << std::endl
+                          << "expected: " << to_string(expected_all) << std::endl
+                          << "actual: " << to_string(actual_all) << std::endl;
+                return false;
+            }
+            ++checked;
+        }
+    }
+
+    if (checked == 0) {
+        std::cout << "no textured crop to check" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool template_match_bench(const std::filesystem::path& testset_dir)
+{
+    constexpr int kRounds = 20;
+
+    auto screenshots = load_screenshots(testset_dir);
+    if (screenshots.empty()) {
+        std::cout << "no screenshot" << std::endl;
+        return false;
+    }
+
+    Fixture fixture;
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    microseconds reference_cost { };
+    microseconds framework_cost { };
+    size_t count = 0;
+
+    for (const cv::Mat& image : screenshots) {
+        for (const cv::Rect& rect : template_rects(image)) {
+            cv::Mat templ = image(rect).clone();
+            fixture.set_template(templ);
+            // 第一次有模板准备等开销，不计入
+            if (!fixture.match(image)) {
+                std::cout << "TemplateMatch failed" << std::endl;
+                return false;
+            }
+
+            auto start = steady_clock::now();
+            for (int r = 0; r < kRounds; ++r) {
+                std::ignore = reference_match(image, templ);
+            }
+            reference_cost += duration_cast<microseconds>(steady_clock::now() - start);
+
+            start = steady_clock::now();
+            for (int r = 0; r < kRounds; ++r) {
+                std::ignore = fixture.match(image);
+            }
+            framework_cost += duration_cast<microseconds>(steady_clock::now() - start);
+
+            count += kRounds;
+        }
+    }
+
+    if (count == 0) {
+        std::cout << "no textured crop to bench" << std::endl;
+        return false;
+    }
+
+    std::cout << "TemplateMatch bench, runs: " << count << ", reference avg: " << reference_cost.count() / count
+              << "us, framework avg (including task overhead): " << framework_cost.count() / count << "us" << std::endl;
+    return true;
+}
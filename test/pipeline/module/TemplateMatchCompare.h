@@ -0,0 +1,9 @@
+#pragma once
+
+#include <filesystem>
+
+// 框架的 TemplateMatch 结果必须与逐点扫描 + 两两 NMS 的参照实现完全一致
+bool template_match_compare(const std::filesystem::path& testset_dir);
+
+// 打印两者的耗时，只在出错时返回 false
+bool template_match_bench(const std::filesystem::path& testset_dir);
@@ -0,0 +1,255 @@
+#include "TestingUtils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+#include <tuple>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+FrameSequenceController::FrameSequenceController(std::vector<cv::Mat> frames)
+    : frames_(std::move(frames))
+{
+    callbacks_.connect = &FrameSequenceController::on_connect;
+    callbacks_.request_uuid = &FrameSequenceController::on_request_uuid;
+    callbacks_.get_features = &FrameSequenceController::on_get_features;
+    callbacks_.screencap = &FrameSequenceController::on_screencap;
+    callbacks_.click = &FrameSequenceController::on_click;
+
+    handle_ = MaaCustomControllerCreate(&callbacks_, this);
+    MaaControllerWait(handle_, MaaControllerPostConnection(handle_));
+}
+
+FrameSequenceController::~FrameSequenceController()
+{
+    MaaControllerDestroy(handle_);
+}
+
+void FrameSequenceController::reset(std::vector<cv::Mat> frames)
+{
+    std::unique_lock lock(mutex_);
+    frames_ = std::move(frames);
+    count_ = 0;
+}
+
+size_t FrameSequenceController::screencap_count() const
+{
+    std::unique_lock lock(mutex_);
+    return count_;
+}
+
+MaaBool FrameSequenceController::on_connect(void* trans_arg)
+{
+    std::ignore = trans_arg;
+    return true;
+}
+
+MaaBool FrameSequenceController::on_request_uuid(void* trans_arg, MaaStringBuffer* buffer)
+{
+    std::ignore = trans_arg;
+    return MaaStringBufferSet(buffer, "FrameSequenceController");
+}
+
+MaaControllerFeature FrameSequenceController::on_get_features(void* trans_arg)
+{
+    std::ignore = trans_arg;
+    return MaaControllerFeature_None;
+}
+
+MaaBool FrameSequenceController::on_screencap(void* trans_arg, MaaImageBuffer* buffer)
+{
+    auto* self = static_cast<FrameSequenceController*>(trans_arg);
+
+    std::unique_lock lock(self->mutex_);
+    if (self->frames_.empty()) {
+        return false;
+    }
+    // frames_ 在控制器存活期间不会被释放，直接交出去即可
+    const cv::Mat& frame = self->frames_.at(std::min(self->count_, self->frames_.size() - 1));
+    ++self->count_;
+    return set_image(buffer, frame);
+}
+
+MaaBool FrameSequenceController::on_click(int32_t x, int32_t y, void* trans_arg)
+{
+    std::ignore = x;
+    std::ignore = y;
+    std::ignore = trans_arg;
+    return true;
+}
+
+RecoRecorder::RecoRecorder(MaaTasker* tasker)
+    : tasker_(tasker)
+{
+    sink_id_ = MaaTaskerAddContextSink(tasker_, &RecoRecorder::on_event, this);
+}
+
+RecoRecorder::~RecoRecorder()
+{
+    MaaTaskerRemoveContextSink(tasker_, sink_id_);
+}
+
+std::vector<json::value> RecoRecorder::records() const
+{
+    std::unique_lock lock(mutex_);
+    return records_;
+}
+
+void RecoRecorder::clear()
+{
+    std::unique_lock lock(mutex_);
+    records_.clear();
+}
+
+void RecoRecorder::on_event(void* handle, const char* message, const char* details_json, void* trans_arg)
+{
+    std::ignore = handle;
+
+    std::string_view msg = message;
+    if (msg != MaaMsg_Node_Recognition_Succeeded && msg != MaaMsg_Node_Recognition_Failed) {
+        return;
+    }
+
+    auto details_opt = json::parse(details_json);
+    if (!details_opt || !details_opt->contains("reco_details")) {
+        return;
+    }
+
+    auto* self = static_cast<RecoRecorder*>(trans_arg);
+    std::unique_lock lock(self->mutex_);
+    self->records_.emplace_back(details_opt->at("reco_details"));
+}
+
+std::vector<cv::Mat> load_screenshots(const std::filesystem::path& testset_dir)
+{
+    auto screenshot_dir = testset_dir / "PipelineSmoking" / "Screenshot";
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(screenshot_dir)) {
+        if (entry.is_regular_file()) {
+            paths.emplace_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+
+    std::vector<cv::Mat> images;
+    for (const auto& path : paths) {
+        cv::Mat image = cv::imread(path.string(), cv::IMREAD_COLOR);
+        if (!image.empty()) {
+            images.emplace_back(std::move(image));
+        }
+    }
+    return images;
+}
+
+bool textured(const cv::Mat& patch)
+{
+    cv::Mat gray;
+    cv::cvtColor(patch, gray, cv::COLOR_BGR2GRAY);
+    cv::Scalar mean;
+    cv::Scalar stddev;
+    cv::meanStdDev(gray, mean, stddev);
+    return stddev[0] > 20.0;
+}
+
+bool set_image(MaaImageBuffer* buffer, const cv::Mat& image)
+{
+    if (!image.isContinuous()) {
+        std::cout << "image is not continuous" << std::endl;
+        return false;
+    }
+    return MaaImageBufferSetRawData(buffer, image.data, image.cols, image.rows, image.type());
+}
+
+std::optional<json::object> get_reco_detail(const MaaTasker* tasker, MaaRecoId reco_id)
+{
+    auto* name = MaaStringBufferCreate();
+    auto* algorithm = MaaStringBufferCreate();
+    auto* box = MaaRectCreate();
+    auto* detail = MaaStringBufferCreate();
+    MaaBool hit = false;
+
+    std::optional<json::object> result = std::nullopt;
+    if (MaaTaskerGetRecognitionDetail(tasker, reco_id, name, algorithm, &hit, box, detail, nullptr, nullptr)) {
+        result = json::object {
+            { "name", MaaStringBufferGet(name) },
+            { "algorithm", MaaStringBufferGet(algorithm) },
+            { "hit", static_cast<bool>(hit) },
+            { "box", json::array { MaaRectGetX(box), MaaRectGetY(box), MaaRectGetW(box), MaaRectGetH(box) } },
+            { "detail", json::parse(MaaStringBufferGet(detail)).value_or(json::value { }) },
+        };
+    }
+
+    MaaStringBufferDestroy(name);
+    MaaStringBufferDestroy(algorithm);
+    MaaRectDestroy(box);
+    MaaStringBufferDestroy(detail);
+
+    return result;
+}
+
+std::optional<json::object>
+    run_direct_recognition(MaaTasker* tasker, const std::string& reco_type, const json::value& reco_param, const cv::Mat& image)
+{
+    auto* image_buffer = MaaImageBufferCreate();
+    set_image(image_buffer, image);
+
+    std::string param_str = reco_param.to_string();
+    MaaTaskId task_id = MaaTaskerPostRecognition(tasker, reco_type.c_str(), param_str.c_str(), image_buffer);
+    MaaTaskerWait(tasker, task_id);
+    MaaImageBufferDestroy(image_buffer);
+
+    MaaNodeId node_id = MaaInvalidId;
+    MaaSize node_count = 1;
+    if (!MaaTaskerGetTaskDetail(tasker, task_id, nullptr, &node_id, &node_count, nullptr) || node_count == 0) {
+        return std::nullopt;
+    }
+
+    MaaRecoId reco_id = MaaInvalidId;
+    if (!MaaTaskerGetNodeDetail(tasker, node_id, nullptr, &reco_id, nullptr, nullptr)) {
+        return std::nullopt;
+    }
+
+    return get_reco_detail(tasker, reco_id);
+}
+
+json::value strip_reco_ids(json::value value)
+{
+    if (value.is_object()) {
+        json::object obj;
+        for (auto& [key, child] : value.as_object()) {
+            if (key == "reco_id") {
+                continue;
+            }
+            obj.emplace(key, strip_reco_ids(child));
+        }
+        return obj;
+    }
+    if (value.is_array()) {
+        json::array arr;
+        for (auto& child : value.as_array()) {
+            arr.emplace_back(strip_reco_ids(child));
+        }
+        return arr;
+    }
+    return value;
+}
+
+void collect_reco_ids(const json::value& value, std::vector<MaaRecoId>& ids)
+{
+    if (value.is_object()) {
+        for (const auto& [key, child] : value.as_object()) {
+            if (key == "reco_id" && child.is_number()) {
+                ids.emplace_back(child.as<MaaRecoId>());
+                continue;
+            }
+            collect_reco_ids(child, ids);
+        }
+    }
+    else if (value.is_array()) {
+        for (const auto& child : value.as_array()) {
+            collect_reco_ids(child, ids);
+        }
+    }
+}
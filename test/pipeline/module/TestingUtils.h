@@ -0,0 +1,86 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <meojson/json.hpp>
+#include <opencv2/core.hpp>
+
+#include "MaaFramework/MaaAPI.h"
+
+// 按截图次数依次返回 frames 的自定义控制器，放完了就一直返回最后一帧
+class FrameSequenceController
+{
+public:
+    explicit FrameSequenceController(std::vector<cv::Mat> frames);
+    ~FrameSequenceController();
+
+    FrameSequenceController(const FrameSequenceController&) = delete;
+    FrameSequenceController& operator=(const FrameSequenceController&) = delete;
+
+    MaaController* handle() const { return handle_; }
+
+    void reset(std::vector<cv::Mat> frames);
+    size_t screencap_count() const;
+
+private:
+    static MaaBool on_connect(void* trans_arg);
+    static MaaBool on_request_uuid(void* trans_arg, MaaStringBuffer* buffer);
+    static MaaControllerFeature on_get_features(void* trans_arg);
+    static MaaBool on_screencap(void* trans_arg, MaaImageBuffer* buffer);
+    static MaaBool on_click(int32_t x, int32_t y, void* trans_arg);
+
+    MaaCustomControllerCallbacks callbacks_ { };
+    MaaController* handle_ = nullptr;
+
+    mutable std::mutex mutex_;
+    std::vector<cv::Mat> frames_;
+    size_t count_ = 0;
+};
+
+// 记录任务中每一次 Node.Recognition.Succeeded / Failed 的 reco_details
+class RecoRecorder
+{
+public:
+    explicit RecoRecorder(MaaTasker* tasker);
+    ~RecoRecorder();
+
+    RecoRecorder(const RecoRecorder&) = delete;
+    RecoRecorder& operator=(const RecoRecorder&) = delete;
+
+    std::vector<json::value> records() const;
+    void clear();
+
+private:
+    static void on_event(void* handle, const char* message, const char* details_json, void* trans_arg);
+
+    MaaTasker* tasker_ = nullptr;
+    MaaSinkId sink_id_ = MaaInvalidId;
+
+    mutable std::mutex mutex_;
+    std::vector<json::value> records_;
+};
+
+// TestingDataSet/PipelineSmoking/Screenshot 下的所有截图
+std::vector<cv::Mat> load_screenshots(const std::filesystem::path& testset_dir);
+
+// 纹理太少的区域到处都能匹配上，拿来当模板比不出差异
+bool textured(const cv::Mat& patch);
+
+bool set_image(MaaImageBuffer* buffer, const cv::Mat& image);
+
+// { name, algorithm, hit, box, detail }，reco_id 不存在时返回 nullopt
+std::optional<json::object> get_reco_detail(const MaaTasker* tasker, MaaRecoId reco_id);
+
+// 对 image 直接跑一次识别（不经过 next 列表，也就没有任何跨帧缓存），返回识别详情
+std::optional<json::object>
+    run_direct_recognition(MaaTasker* tasker, const std::string& reco_type, const json::value& reco_param, const cv::Mat& image);
+
+// 递归去掉所有 reco_id，便于比较两次运行的识别详情
+json::value strip_reco_ids(json::value value);
+
+// 递归收集 reco_details 里出现的所有 reco_id（包含 And / Or 的子识别）
+void collect_reco_ids(const json::value& value, std::vector<MaaRecoId>& ids);
@@ -252,12 +252,14 @@ def test_resource_api():
     r2 = Resource()
     r2.use_directml(0)
     r2.use_cpu()
+    r2.set_ocr_session_pool_size(4)
 
     # 测试无效路径加载（应该失败但不崩溃）
     r2.post_bundle("C:/_maafw_testing_/aaabbbccc").wait()
 
     # 测试 loaded 属性
     print(f"  r2.loaded (after invalid path): {r2.loaded}")
+    print(f"  r2.ocr_session_pool_stats: {r2.ocr_session_pool_stats}")
 
     # 测试事件监听器
     resource = Resource()
@@ -431,6 +433,7 @@ def test_controller_api():
     dbg_controller.set_screenshot_target_long_side(1920)
     dbg_controller.set_screenshot_target_short_side(1080)
     dbg_controller.set_screenshot_use_raw_size(False)
+    dbg_controller.set_continuous_screencap(0)
 
     # 测试 remove_sink 和 clear_sinks
     assert sink_id is not None, "sink_id should not be None"
@@ -480,6 +483,7 @@ def test_tasker_api(resource: Resource, controller: DbgController):
     Tasker.set_save_on_error(True)
     Tasker.set_draw_quality(85)
     Tasker.set_reco_image_cache_limit(4096)
+    Tasker.set_parallel_next_list(False)
 
     # 创建 Tasker
     tasker = Tasker()
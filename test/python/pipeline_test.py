@@ -505,6 +505,7 @@ class PipelineTestRecognition(CustomRecognition):
                     "index": 1,
                     "method": 3,
                     "green_mask": True,
+                    "pyramid": 2,
                 }
             }
         )
@@ -520,6 +521,7 @@ class PipelineTestRecognition(CustomRecognition):
         assert_eq(param.index, 1, "index")
         assert_eq(param.method, 3, "method")
         assert_eq(param.green_mask, True, "green_mask")
+        assert_eq(param.pyramid, 2, "pyramid")
 
         # FeatureMatch
         new_ctx.override_pipeline(